@@ -27,6 +27,7 @@ public class GenericPhysicPropSystem : ModuleRules
 			{
 				"Core",
 				"PhysicsCore",
+				"NetCore",
 				"GenericDamageSystemPlugin",
 				// ... add other public dependencies that you statically link with here ...
 			}
@@ -38,11 +39,21 @@ public class GenericPhysicPropSystem : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"DeveloperSettings",
 				"Slate",
 				"SlateCore",
+				"Json",
+				"Chaos",
+				"Niagara",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
+
+		// Rest state baking duplicates the edited level
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
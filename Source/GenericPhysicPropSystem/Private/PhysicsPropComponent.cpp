@@ -6,8 +6,22 @@
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/DamageType.h"
 #include "PhysicsPropDamageType.h"
-#include "GenericDamageType.h"
+#include "PhysicsPropSubsystem.h"
+#include "PhysicsPropSettings.h"
 #include "PhysicalMaterials/PhysicalMaterial.h" // Necessary for audio interactions
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/PhysicsHandleComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Sound/SoundBase.h"
+#include "Net/UnrealNetwork.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+#include "PhysicsPropStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Prop Tick"), STAT_PhysicsProps_ComponentTick, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Update Grabbed Position"), STAT_PhysicsProps_UpdateGrabbedPosition, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Component Hit"), STAT_PhysicsProps_ComponentHit, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Damage Handlers"), STAT_PhysicsProps_Damage, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Flush Damage Impulses"), STAT_PhysicsProps_FlushDamage, STATGROUP_PhysicsProps);
 
 // Sets default values for this component's properties
 UPhysicsPropComponent::UPhysicsPropComponent()
@@ -15,7 +29,7 @@ UPhysicsPropComponent::UPhysicsPropComponent()
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
 	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = false; // Enable tick only when the object moves
+	PrimaryComponentTick.bStartWithTickEnabled = false; // Enable tick only while grabbed, CCD is batched by the subsystem
 
 	// Default values
 	PhysicsCullDistance = 3000.0f;
@@ -28,10 +42,13 @@ void UPhysicsPropComponent::Physicalize(UStaticMeshComponent* TargetMesh)
 {
 	if (!TargetMesh) return;
 	ManagedMesh = TargetMesh;
+	DeferredMesh = nullptr;
 
 	// Source Engine style configuration
 	ManagedMesh->SetSimulatePhysics(true);
-	ManagedMesh->SetNotifyRigidBodyCollision(true); // Required for impacts
+	// Required for impacts, unless the subsystem reads the solver's contacts directly
+	const bool bBatchedImpacts = GetDefault<UPhysicsPropSettings>()->bBatchedImpactEvents;
+	ManagedMesh->SetNotifyRigidBodyCollision(!bBatchedImpacts);
 	ManagedMesh->SetGenerateOverlapEvents(false);   // Optimization: no overlaps if unnecessary
     
 	// Prevent actor from ticking needlessly
@@ -41,8 +58,34 @@ void UPhysicsPropComponent::Physicalize(UStaticMeshComponent* TargetMesh)
 	ManagedMesh->OnComponentSleep.AddDynamic(this, &UPhysicsPropComponent::OnPhysicsComponentSleep);
 	ManagedMesh->OnComponentWake.AddDynamic(this, &UPhysicsPropComponent::OnPhysicsComponentWake);
 	
+	StableId = MakeStableId(GetOwner());
+
+	// Only actors loaded with the level have the same path on clients, runtime props keep the normal replication
+	if (GetDefault<UPhysicsPropSettings>()->bAggregatedReplication && GetOwner()->IsNetStartupActor())
+	{
+		// Replicated by the subsystem's manager actor, matched on clients by path name
+		NetId = StableId;
+		if (GetOwnerRole() == ROLE_Authority)
+		{
+			SetIsReplicated(false);
+			GetOwner()->SetReplicates(false);
+		}
+	}
+	else if (bQuantizedReplication && GetOwnerRole() == ROLE_Authority)
+	{
+		// Sleep and wake drive net dormancy, the quantized state replaces FRepMovement
+		SetIsReplicated(true);
+		GetOwner()->SetReplicateMovement(false);
+	}
+	
 	// Bind collision events for audio
-	ManagedMesh->OnComponentHit.AddDynamic(this, &UPhysicsPropComponent::OnComponentHit);
+	if (!bBatchedImpacts)
+	{
+		ManagedMesh->OnComponentHit.AddDynamic(this, &UPhysicsPropComponent::OnComponentHit);
+	}
+
+	// Cache the prop's own surface for material-pair impact sounds
+	CachePropSurface();
 
 	// Aggressive sleep threshold (Source style)
 	// Using BodyInstance. 'Sensitive' = falls asleep faster (lower threshold).
@@ -53,25 +96,52 @@ void UPhysicsPropComponent::Physicalize(UStaticMeshComponent* TargetMesh)
 		// Can also increase damping to help object reach rest state faster
 		ManagedMesh->SetLinearDamping(0.5f); 
 		ManagedMesh->SetAngularDamping(0.5f);
+
+		// Remember the Full LOD settings
+		FullLinearDamping = BodyInst->LinearDamping;
+		FullAngularDamping = BodyInst->AngularDamping;
+		FullPositionIterations = BodyInst->PositionSolverIterationCount;
+		FullVelocityIterations = BodyInst->VelocitySolverIterationCount;
 	}
 
-	// Start optimization timer if necessary
-	if (PhysicsCullDistance > 0.0f)
+	// Distance culling is batched for all props by the subsystem
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
 	{
-		// Randomize timer start to spread CPU load if many objects spawn at once
-		float RandomVariability = FMath::RandRange(0.0f, 0.5f);
-		GetWorld()->GetTimerManager().SetTimer(TimerHandle_DistanceCheck, this, &UPhysicsPropComponent::CheckDistanceToPlayer, DistanceCheckInterval + RandomVariability, true);
+		PropSubsystem->RegisterProp(this);
 	}
 
 	// Bind damage events
+	BindDamageEvents();
+}
+
+void UPhysicsPropComponent::BindDamageEvents()
+{
+	// Unique: queued props are bound in BeginPlay already
 	if (AActor* Owner = GetOwner())
 	{
-		Owner->OnTakeAnyDamage.AddDynamic(this, &UPhysicsPropComponent::OnTakeAnyDamage);
-		Owner->OnTakePointDamage.AddDynamic(this, &UPhysicsPropComponent::OnTakePointDamage);
-		Owner->OnTakeRadialDamage.AddDynamic(this, &UPhysicsPropComponent::OnTakeRadialDamage);
+		Owner->OnTakeAnyDamage.AddUniqueDynamic(this, &UPhysicsPropComponent::OnTakeAnyDamage);
+		Owner->OnTakePointDamage.AddUniqueDynamic(this, &UPhysicsPropComponent::OnTakePointDamage);
+
+		// Projects pushing props with UPhysicsPropSubsystem::ApplyExplosion skip the per-actor dispatch
+		if (GetDefault<UPhysicsPropSettings>()->bBindRadialDamageEvents)
+		{
+			Owner->OnTakeRadialDamage.AddUniqueDynamic(this, &UPhysicsPropComponent::OnTakeRadialDamage);
+		}
 	}
 }
 
+void UPhysicsPropComponent::CachePropSurface()
+{
+	const FBodyInstance* BodyInst = ManagedMesh ? ManagedMesh->GetBodyInstance() : nullptr;
+	PropSurface = UPhysicalMaterial::DetermineSurfaceType(BodyInst ? BodyInst->GetSimplePhysicalMaterial() : nullptr);
+}
+
+uint32 UPhysicsPropComponent::MakeStableId(const AActor* Actor)
+{
+	// Path name without the PIE prefix, PIE instances and baking worlds differ by prefix only
+	return Actor ? FCrc::StrCrc32(*UWorld::RemovePIEPrefix(Actor->GetPathName())) : 0;
+}
+
 void UPhysicsPropComponent::BeginPlay()
 {
 	Super::BeginPlay();
@@ -82,28 +152,59 @@ void UPhysicsPropComponent::BeginPlay()
 		{
 			if (FoundMesh->IsSimulatingPhysics())
 			{
-				Physicalize(FoundMesh);
+				// Level props are spread over the next frames, so a streamed-in sublevel doesn't physicalize all at once
+				UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>();
+				if (PropSubsystem && GetDefault<UPhysicsPropSettings>()->bDeferredRegistration && GetOwner()->IsNetStartupActor())
+				{
+					DeferredMesh = FoundMesh;
+					FoundMesh->SetSimulatePhysics(false);
+					PropSubsystem->QueueRegistration(this);
+
+					// Damage doesn't wait for the queue, it physicalizes the prop right away
+					BindDamageEvents();
+				}
+				else
+				{
+					Physicalize(FoundMesh);
+				}
 			}
 		}
 	}
 }
 
-void UPhysicsPropComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UPhysicsPropComponent::PhysicalizeDeferred()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	// A prop that left play (e.g. its sublevel was hidden) must not come back into the subsystem
+	if (!DeferredMesh || !HasBegunPlay()) return;
 
-	if (!ManagedMesh || CCDSpeedThreshold <= 0.0f) return;
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		PropSubsystem->DequeueRegistration(this);
+	}
+	Physicalize(DeferredMesh);
+}
 
-	// Dynamic CCD management to avoid tunneling at high speeds
-	const float SpeedSq = ManagedMesh->GetComponentVelocity().SizeSquared();
-	const bool bShouldUseCCD = SpeedSq > (CCDSpeedThreshold * CCDSpeedThreshold);
+void UPhysicsPropComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DeferredMesh = nullptr;
 
-	// Only call function if state changes to avoid overhead
-	if (ManagedMesh->BodyInstance.bUseCCD != bShouldUseCCD)
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
 	{
-		ManagedMesh->SetUseCCD(bShouldUseCCD);
+		PropSubsystem->DequeueRegistration(this);
+		PropSubsystem->UnregisterProp(this);
 	}
 
+	Super::EndPlay(EndPlayReason);
+}
+
+void UPhysicsPropComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_ComponentTick);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropComponent::TickComponent);
+	PHYSICSPROP_TIMING_SCOPE(ComponentTick);
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
 	// --- Grab Logic ---
 	if (bIsGrabbed && CurrentHolder)
 	{
@@ -113,13 +214,52 @@ void UPhysicsPropComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 
 void UPhysicsPropComponent::Grab(USceneComponent* Holder)
 {
+	// Still waiting in the registration queue
+	PhysicalizeDeferred();
+
 	if (!Holder || !ManagedMesh) return;
 
+	PromoteToFullLOD();
+
+	// A welded prop leaves its stack, the rest of it stays asleep
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		PropSubsystem->DissolveWeldGroup(this);
+	}
+
 	CurrentHolder = Holder;
 	bIsGrabbed = true;
+	ActiveGrabMode = GrabMode;
 
-	// 1. Disable physics for direct control
-	ManagedMesh->SetSimulatePhysics(false);
+	// 1. Take control of the body
+	if (ActiveGrabMode == EPropGrabMode::PhysicsHandle)
+	{
+		// Keep simulating, a spring pulls the body toward the hold target
+		if (!GrabHandle)
+		{
+			// Unique name: the owner may have several props, or a destroyed handle still waiting for GC
+			GrabHandle = NewObject<UPhysicsHandleComponent>(GetOwner(), MakeUniqueObjectName(GetOwner(), UPhysicsHandleComponent::StaticClass(), TEXT("PropGrabHandle")));
+			GrabHandle->RegisterComponent();
+		}
+		GrabHandle->SetLinearStiffness(GrabLinearStiffness);
+		GrabHandle->SetAngularStiffness(GrabAngularStiffness);
+		GrabHandle->GrabComponentAtLocationWithRotation(ManagedMesh, NAME_None, ManagedMesh->GetComponentLocation(), ManagedMesh->GetComponentRotation());
+
+		HeldPawnResponse = ManagedMesh->GetCollisionResponseToChannel(ECC_Pawn);
+		ManagedMesh->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+	}
+	else
+	{
+		// Disable physics for direct control
+		ManagedMesh->SetSimulatePhysics(false);
+
+		// Moved by kinematic targets on the physics thread, the component follows the simulation results
+		bHeldKinematicFromSimulation = ManagedMesh->BodyInstance.bUpdateKinematicFromSimulation;
+		if (GetPhysicsCallback())
+		{
+			ManagedMesh->BodyInstance.bUpdateKinematicFromSimulation = true;
+		}
+	}
 	
 	// 2. Ignore Player Pawn to avoid pushing oneself (Source-like physics)
 	// Assuming Holder belongs to the Pawn
@@ -139,25 +279,50 @@ void UPhysicsPropComponent::Grab(USceneComponent* Holder)
 	// Min/Max limits (arbitrary, to avoid grabbing something 1km away and keeping it there)
 	HoldDistance = FMath::Clamp(HoldDistance, 50.0f, 250.0f);
 
-	// Wake object to be sure
+	// 4. Anti-clipping sweep setup, constant for the whole grab
+	GrabQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(PropGrabSweep), false, GetOwner()); // Ignore self
+	GrabQueryParams.AddIgnoredActor(Holder->GetOwner()); // Ignore player
+	GrabTraceHandle = FTraceHandle();
+	GrabSafeFraction = 1.0f;
+	CacheGrabSweepShape();
+
+	// Tick only while held to follow the holder
 	SetComponentTickEnabled(true);
+
+	// Held objects move without simulating, keep their position tracked
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		PropSubsystem->SetPropAwake(this, true);
+	}
 }
 
 void UPhysicsPropComponent::Drop()
 {
 	if (!bIsGrabbed || !ManagedMesh) return;
 
-	// Reactivate physics
-	ManagedMesh->SetSimulatePhysics(true);
+	if (ActiveGrabMode == EPropGrabMode::PhysicsHandle)
+	{
+		// The body never stopped simulating and keeps its own velocity
+		GrabHandle->ReleaseComponent();
+		ManagedMesh->SetCollisionResponseToChannel(ECC_Pawn, HeldPawnResponse);
+	}
+	else
+	{
+		// Reactivate physics
+		ManagedMesh->BodyInstance.bUpdateKinematicFromSimulation = bHeldKinematicFromSimulation;
+		ManagedMesh->SetSimulatePhysics(true);
+	}
 	
-	// Preserve inertia (if player runs and drops, object continues)
 	if (CurrentHolder)
 	{
 		AActor* HolderOwner = CurrentHolder->GetOwner();
-		// Try to get player velocity if possible
 		if (HolderOwner)
 		{
-			ManagedMesh->SetPhysicsLinearVelocity(HolderOwner->GetVelocity());
+			// Preserve inertia (if player runs and drops, object continues)
+			if (ActiveGrabMode == EPropGrabMode::Teleport)
+			{
+				ManagedMesh->SetPhysicsLinearVelocity(HolderOwner->GetVelocity());
+			}
 			
 			// Restore collisions with player
 			ManagedMesh->IgnoreActorWhenMoving(HolderOwner, false);
@@ -173,6 +338,8 @@ void UPhysicsPropComponent::Drop()
 	// Cleanup
 	bIsGrabbed = false;
 	CurrentHolder = nullptr;
+	GrabTraceHandle = FTraceHandle(); // Pending sweep result is simply never read
+	SetComponentTickEnabled(false);
 }
 
 void UPhysicsPropComponent::Throw(FVector Direction, float Force)
@@ -188,143 +355,639 @@ void UPhysicsPropComponent::Throw(FVector Direction, float Force)
 
 void UPhysicsPropComponent::UpdateGrabbedPosition()
 {
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_UpdateGrabbedPosition);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropComponent::UpdateGrabbedPosition);
+	PHYSICSPROP_TIMING_SCOPE(UpdateGrabbedPosition);
+
 	if (!CurrentHolder || !ManagedMesh) return;
 
-	FVector TargetLocation = CurrentHolder->GetComponentLocation() + (CurrentHolder->GetForwardVector() * HoldDistance);
+	UWorld* World = GetWorld();
+	const FVector StartTrace = CurrentHolder->GetComponentLocation();
+	FVector TargetLocation = StartTrace + (CurrentHolder->GetForwardVector() * HoldDistance);
 	FRotator TargetRotation = CurrentHolder->GetComponentRotation(); // Alternatively keep object rot. Here we lock like an FPS.
 
 	// --- ANTI-CLIPPING ---
 	// Cast a ray (Sweep) from player to target object position.
 	// If hitting a wall, pull object closer so it doesn't clip through.
-	
-	FHitResult Hit;
-	FCollisionQueryParams Params;
-	Params.AddIgnoredActor(GetOwner()); // Ignore self
-	Params.AddIgnoredActor(CurrentHolder->GetOwner()); // Ignore player
 
-	FVector StartTrace = CurrentHolder->GetComponentLocation();
-	
-	// Sweep with a sphere slightly smaller than object (approx 10cm here)
-	// Ideally use object collision box but that is heavy.
-	bool bHit = GetWorld()->SweepSingleByChannel(
-		Hit, 
-		StartTrace, 
-		TargetLocation, 
-		FQuat::Identity, 
-		ECC_Visibility, // Visibility channel or Camera to detect walls
-		FCollisionShape::MakeSphere(10.0f), 
-		Params
-	);
+	if (bAsyncGrabSweep)
+	{
+		// Read the sweep issued last frame (one frame of latency, hidden by the smoothing below)
+		FTraceDatum Datum;
+		if (GrabTraceHandle.IsValid() && World->QueryTraceData(GrabTraceHandle, Datum))
+		{
+			if (Datum.OutHits.Num() == 0 || !Datum.OutHits[0].bBlockingHit)
+			{
+				GrabSafeFraction = 1.0f;
+			}
+			else if (!Datum.OutHits[0].bStartPenetrating)
+			{
+				GrabSafeFraction = Datum.OutHits[0].Time;
+			}
+			// Else the shape already touches something at the holder (e.g. looking at the floor), keep the last distance
+		}
 
-	if (bHit)
+		// Sweep the object's own shape toward its ideal position, read next frame
+		const FQuat TargetQuat = TargetRotation.Quaternion();
+		const FVector ShapeOffset = TargetQuat.RotateVector(GrabShapeOffset);
+		GrabTraceHandle = World->AsyncSweepByChannel(
+			EAsyncTraceType::Single,
+			StartTrace + ShapeOffset,
+			TargetLocation + ShapeOffset,
+			TargetQuat * GrabShapeRotation,
+			ECC_Visibility,
+			GrabSweepShape,
+			GrabQueryParams
+		);
+
+		// The shape matches the object, so stopping at the free fraction keeps it out of the wall
+		TargetLocation = FMath::Lerp(StartTrace, TargetLocation, GrabSafeFraction);
+	}
+	else
 	{
-		// If wall hit, place object just BEFORE impact point
-		// Add small offset (Normal * Radius) to not stick origin into wall
-		TargetLocation = Hit.Location + (Hit.ImpactNormal * 12.0f);
+		// Sweep with a sphere slightly smaller than object (approx 10cm here)
+		FHitResult Hit;
+		bool bHit = World->SweepSingleByChannel(
+			Hit, 
+			StartTrace, 
+			TargetLocation, 
+			FQuat::Identity, 
+			ECC_Visibility, // Visibility channel or Camera to detect walls
+			FCollisionShape::MakeSphere(10.0f), 
+			GrabQueryParams
+		);
+
+		if (bHit)
+		{
+			// If wall hit, place object just BEFORE impact point
+			// Add small offset (Normal * Radius) to not stick origin into wall
+			TargetLocation = Hit.Location + (Hit.ImpactNormal * 12.0f);
+		}
+	}
+
+	INC_DWORD_STAT(STAT_PhysicsProps_GrabSweeps);
+	CSV_CUSTOM_STAT(PhysicsProps, GrabSweeps, 1, ECsvCustomStatOp::Accumulate);
+
+	if (ActiveGrabMode == EPropGrabMode::PhysicsHandle)
+	{
+		// The handle moves its kinematic target toward this every physics step
+		GrabHandle->SetTargetLocationAndRotation(TargetLocation, TargetRotation);
+		return;
 	}
 
 	// Smooth movement (VInterp) to avoid stuttering if moving fast
-	FVector NewLoc = FMath::VInterpTo(GetOwner()->GetActorLocation(), TargetLocation, GetWorld()->GetDeltaSeconds(), 20.0f);
-	FRotator NewRot = FMath::RInterpTo(GetOwner()->GetActorRotation(), TargetRotation, GetWorld()->GetDeltaSeconds(), 20.0f);
+	FVector NewLoc = FMath::VInterpTo(GetOwner()->GetActorLocation(), TargetLocation, World->GetDeltaSeconds(), 20.0f);
+	FRotator NewRot = FMath::RInterpTo(GetOwner()->GetActorRotation(), TargetRotation, World->GetDeltaSeconds(), 20.0f);
 
-	GetOwner()->SetActorLocationAndRotation(NewLoc, NewRot, true); // true = Sweep (tries to slide along walls too)
+	// The physics thread moves the body toward it at every step
+	FPropPhysicsCallback* PhysicsCallback = GetPhysicsCallback();
+	FSingleParticlePhysicsProxy* Proxy = GetPhysicsProxy();
+	if (PhysicsCallback && Proxy)
+	{
+		const FTransform MeshToActor = ManagedMesh->GetComponentTransform().GetRelativeTransform(GetOwner()->GetActorTransform());
+		PhysicsCallback->SetKinematicTarget_External(Proxy, MeshToActor * FTransform(NewRot, NewLoc));
+		return;
+	}
+
+	// The async sweep already checked the target with the object's own shape, the small sphere above didn't
+	GetOwner()->SetActorLocationAndRotation(NewLoc, NewRot, !bAsyncGrabSweep); // Sweep slides along walls
+}
+
+FPropPhysicsCallback* UPhysicsPropComponent::GetPhysicsCallback() const
+{
+	const UPhysicsPropSubsystem* PropSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPhysicsPropSubsystem>() : nullptr;
+	return PropSubsystem ? PropSubsystem->GetPhysicsCallback() : nullptr;
 }
 
-void UPhysicsPropComponent::CheckDistanceToPlayer()
+FSingleParticlePhysicsProxy* UPhysicsPropComponent::GetPhysicsProxy() const
 {
-	if (!ManagedMesh || !GetWorld()) return;
+	const FBodyInstance* BodyInstance = ManagedMesh ? ManagedMesh->GetBodyInstance() : nullptr;
+	return BodyInstance ? BodyInstance->GetPhysicsActorHandle() : nullptr;
+}
 
-	// Basic safety: If object falls too low (under map), destroy it to save perfs
-	if (GetOwner()->GetActorLocation().Z < -20000.0f) // -200 meters
+void UPhysicsPropComponent::CacheGrabSweepShape()
+{
+	const FVector Scale = ManagedMesh->GetComponentScale().GetAbs();
+	const UBodySetup* BodySetup = ManagedMesh->GetBodySetup();
+	const FKAggregateGeom* AggGeom = BodySetup ? &BodySetup->AggGeom : nullptr;
+
+	// Shapes are built in mesh space, then placed like the kinematic target: through the mesh-to-actor transform
+	const FTransform MeshToActor = ManagedMesh->GetComponentTransform().GetRelativeTransform(GetOwner()->GetActorTransform());
+	const FVector ActorScale = GetOwner()->GetActorScale3D();
+	FVector LocalCenter = FVector::ZeroVector;
+	GrabShapeRotation = MeshToActor.GetRotation();
+
+	// Single primitive: sweep the exact shape
+	bool bExactShape = false;
+	if (AggGeom && AggGeom->GetElementCount() == 1)
 	{
-		GetOwner()->Destroy();
-		return;
+		if (AggGeom->SphereElems.Num() == 1)
+		{
+			const FKSphereElem& Sphere = AggGeom->SphereElems[0];
+			GrabSweepShape = FCollisionShape::MakeSphere(Sphere.Radius * Scale.GetMin());
+			LocalCenter = Sphere.Center;
+			bExactShape = true;
+		}
+		else if (AggGeom->BoxElems.Num() == 1 && AggGeom->BoxElems[0].Rotation.IsNearlyZero())
+		{
+			const FKBoxElem& Box = AggGeom->BoxElems[0];
+			GrabSweepShape = FCollisionShape::MakeBox(FVector(Box.X, Box.Y, Box.Z) * 0.5f * Scale);
+			LocalCenter = Box.Center;
+			bExactShape = true;
+		}
+	}
+
+	// Anything else (several primitives, convex hulls): box around the simplified collision
+	if (!bExactShape)
+	{
+		FBox LocalBox(ForceInit);
+		if (AggGeom && AggGeom->GetElementCount() > 0)
+		{
+			LocalBox = AggGeom->CalcAABB(FTransform::Identity);
+		}
+		else if (const UStaticMesh* Mesh = ManagedMesh->GetStaticMesh())
+		{
+			LocalBox = Mesh->GetBoundingBox();
+		}
+
+		if (LocalBox.IsValid)
+		{
+			GrabSweepShape = FCollisionShape::MakeBox(LocalBox.GetExtent() * Scale);
+			LocalCenter = LocalBox.GetCenter();
+		}
+		else
+		{
+			GrabSweepShape = FCollisionShape::MakeSphere(10.0f);
+		}
 	}
 
-	// Find camera or player pawn (generic method without cast)
-	APlayerController* PC = GetWorld()->GetFirstPlayerController();
-	if (!PC) return;
+	GrabShapeOffset = MeshToActor.TransformPosition(LocalCenter) * ActorScale;
+}
 
-	FVector ObserverLoc;
-	FRotator ObserverRot;
-	PC->GetPlayerViewPoint(ObserverLoc, ObserverRot);
+bool UPhysicsPropComponent::ApplyPhysicsLOD(EPropPhysicsLOD NewLOD)
+{
+	if (!ManagedMesh || bIsGrabbed) return false;
+	if (NewLOD == PhysicsLOD) return true;
 
-	const float DistSq = FVector::DistSquared(ObserverLoc, GetOwner()->GetActorLocation());
-	const float CullDistSq = PhysicsCullDistance * PhysicsCullDistance;
+	const EPropPhysicsLOD OldLOD = PhysicsLOD;
+	PhysicsLOD = NewLOD;
 
-	// If far away
-	if (DistSq > CullDistSq)
+	// Leaving dormancy: show the prop again and put the body back into the scene
+	if (OldLOD == EPropPhysicsLOD::Dormant)
 	{
-		// If object is awake, force sleep to save CPU
-		if (ManagedMesh->IsSimulatingPhysics() && ManagedMesh->GetBodyInstance()->IsInstanceAwake())
+		if (bHibernated)
 		{
-			ManagedMesh->PutAllRigidBodiesToSleep();
+			if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+			{
+				PropSubsystem->RehydrateProp(this);
+			}
 		}
-		
-		// Reduce mesh tick frequency if active
-		ManagedMesh->SetComponentTickInterval(1.0f);
+		ManagedMesh->SetCollisionEnabled(DormantCollisionEnabled);
 	}
-	else
+
+	switch (NewLOD)
 	{
+	case EPropPhysicsLOD::Full:
+	case EPropPhysicsLOD::Reduced:
+		// A welded prop is a shape of its group's first prop, whose tier drives the whole compound body
+		if (!ManagedMesh->IsWelded())
+		{
+			ApplyTierBodySettings();
+		}
+
 		// Close by: restore normal tick rate for max smoothness
 		ManagedMesh->SetComponentTickInterval(0.0f);
+		break;
+
+	case EPropPhysicsLOD::Frozen:
+		// Stays in place and keeps colliding, but costs nothing to the solver
+		ManagedMesh->SetSimulatePhysics(false);
+		ManagedMesh->SetComponentTickInterval(1.0f);
+		break;
+
+	case EPropPhysicsLOD::Dormant:
+		// Without collision the body is removed from the physics scene, it comes back with its authored collision
+		ApplyCollisionLOD(nullptr);
+		ManagedMesh->SetSimulatePhysics(false);
+		DormantCollisionEnabled = ManagedMesh->GetCollisionEnabled();
+		DormantSinceTime = GetWorld()->GetTimeSeconds();
+		ManagedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		ManagedMesh->SetComponentTickInterval(1.0f);
+		break;
 	}
+
+	// Frozen and Dormant props don't move, only awake props of the closer tiers replicate
+	if (bQuantizedReplication && GetOwnerRole() == ROLE_Authority)
+	{
+		const bool bCloseTier = NewLOD == EPropPhysicsLOD::Full || NewLOD == EPropPhysicsLOD::Reduced;
+		SetNetAwake(bCloseTier && ManagedMesh->IsAnyRigidBodyAwake());
+	}
+
+	return true;
+}
+
+bool UPhysicsPropComponent::ApplyCollisionLOD(UBodySetup* SimpleSetup)
+{
+	if (!ManagedMesh || bIsGrabbed || WeldGroup != INDEX_NONE) return false;
+
+	// Not through GetBodyInstance, which would return the body of a weld parent
+	FBodyInstance& BodyInst = ManagedMesh->BodyInstance;
+	UBodySetup* Setup = SimpleSetup ? SimpleSetup : ManagedMesh->GetBodySetup();
+	if (!Setup || !BodyInst.IsValidBodyInstance()) return false;
+	if (BodyInst.GetBodySetup() == Setup) return true;
+
+	const bool bSimulating = ManagedMesh->IsSimulatingPhysics();
+	const bool bAwake = bSimulating && ManagedMesh->RigidBodyIsAwake();
+	const FVector LinearVelocity = bAwake ? ManagedMesh->GetPhysicsLinearVelocity() : FVector::ZeroVector;
+	const FVector AngularVelocity = bAwake ? ManagedMesh->GetPhysicsAngularVelocityInRadians() : FVector::ZeroVector;
+
+	// The simple shape is bigger than the authored one, its mass would be too
+	if (SimpleSetup && BodyInst.GetBodySetup() == ManagedMesh->GetBodySetup())
+	{
+		FullMassInKg = BodyInst.GetMassOverride();
+		bFullOverrideMass = BodyInst.bOverrideMass;
+		BodyInst.SetMassOverride(BodyInst.GetBodyMass());
+	}
+	else if (!SimpleSetup)
+	{
+		BodyInst.SetMassOverride(FullMassInKg, bFullOverrideMass);
+	}
+
+	BodyInst.TermBody();
+	BodyInst.InitBody(Setup, ManagedMesh->GetComponentTransform(), ManagedMesh, GetWorld()->GetPhysicsScene());
+
+	if (bAwake)
+	{
+		BodyInst.SetLinearVelocity(LinearVelocity, false);
+		BodyInst.SetAngularVelocityInRadians(AngularVelocity, false);
+	}
+	else if (bSimulating)
+	{
+		BodyInst.PutInstanceToSleep();
+	}
+
+	return true;
+}
+
+void UPhysicsPropComponent::ApplyTierBodySettings()
+{
+	const bool bReduced = PhysicsLOD == EPropPhysicsLOD::Reduced;
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+
+	if (!ManagedMesh->IsSimulatingPhysics())
+	{
+		ManagedMesh->SetSimulatePhysics(true);
+	}
+
+	if (FBodyInstance* BodyInst = ManagedMesh->GetBodyInstance())
+	{
+		BodyInst->SetPositionSolverIterationCount(bReduced ? static_cast<uint8>(Settings->ReducedPositionIterations) : FullPositionIterations);
+		BodyInst->SetVelocitySolverIterationCount(bReduced ? static_cast<uint8>(Settings->ReducedVelocityIterations) : FullVelocityIterations);
+	}
+	ManagedMesh->SetLinearDamping(bReduced ? Settings->ReducedDamping : FullLinearDamping);
+	ManagedMesh->SetAngularDamping(bReduced ? Settings->ReducedDamping : FullAngularDamping);
+}
+
+void UPhysicsPropComponent::PromoteToFullLOD()
+{
+	UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>();
+
+	// Damage on any prop of a welded stack brings its compound body, owned by the first prop, to Full
+	if (PropSubsystem && WeldGroup != INDEX_NONE)
+	{
+		UPhysicsPropComponent* Root = PropSubsystem->GetWeldRoot(this);
+		if (Root != this)
+		{
+			Root->PromoteToFullLOD();
+		}
+	}
+
+	// Keep it there for a while, or the next LOD pass would demote it again before it even moved
+	FullLODHoldUntilTime = GetWorld()->GetTimeSeconds() + GetDefault<UPhysicsPropSettings>()->LODPromotionHoldTime;
+
+	if (PhysicsLOD == EPropPhysicsLOD::Full) return;
+
+	if (ApplyPhysicsLOD(EPropPhysicsLOD::Full) && PropSubsystem)
+	{
+		PropSubsystem->NotifyPropLODChanged(this);
+	}
+}
+
+void UPhysicsPropComponent::DeactivateForPool()
+{
+	if (!ManagedMesh || bPooled) return;
+
+	if (bIsGrabbed)
+	{
+		Drop();
+	}
+
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		PropSubsystem->DissolveWeldGroup(this);
+	}
+
+	// Leave in a clean Full state with the authored collision, collision of a dormant prop is restored on the way
+	ApplyPhysicsLOD(EPropPhysicsLOD::Full);
+	ApplyCollisionLOD(nullptr);
+
+	PendingDamageVelocityChange = FVector::ZeroVector;
+	PendingDamageImpulse = FVector::ZeroVector;
+	PendingDamageAngularImpulse = FVector::ZeroVector;
+	bPendingDamageWake = false;
+
+	PooledCollisionEnabled = ManagedMesh->GetCollisionEnabled();
+	ManagedMesh->SetSimulatePhysics(false);
+	ManagedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GetOwner()->SetActorHiddenInGame(true);
+	bPooled = true;
+}
+
+void UPhysicsPropComponent::ReactivateFromPool(const FTransform& Transform)
+{
+	if (!ManagedMesh || !bPooled) return;
+
+	bPooled = false;
+	GetOwner()->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	GetOwner()->SetActorHiddenInGame(false);
+
+	ManagedMesh->SetCollisionEnabled(PooledCollisionEnabled);
+	ManagedMesh->SetSimulatePhysics(true);
+	ManagedMesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+	ManagedMesh->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+	LastImpactTime = 0.0f;
+
+	// The mesh may have been swapped while pooled, its body is back with the new physical material
+	CachePropSurface();
 }
 
 void UPhysicsPropComponent::OnPhysicsComponentSleep(UPrimitiveComponent* SleepingComponent, FName BoneName)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("PhysicsProps_Sleep", PhysicsPropsChannel);
+
 	// Object asleep: cut consumption
-	SetComponentTickEnabled(false); // No need to check speed
-	
 	GetOwner()->SetActorTickEnabled(false);
+	AsleepSinceTime = GetWorld()->GetTimeSeconds();
+
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		PropSubsystem->SetPropAwake(this, false);
+	}
     
-	// Optional: Disable movement replication to save bandwidth
+	// Stop replicating to save bandwidth
 	if (GetOwnerRole() == ROLE_Authority)
 	{
-		GetOwner()->SetReplicateMovement(false);
+		if (bQuantizedReplication)
+		{
+			SetNetAwake(false);
+		}
+		else
+		{
+			GetOwner()->SetReplicateMovement(false);
+		}
 	}
 }
 
 void UPhysicsPropComponent::OnPhysicsComponentWake(UPrimitiveComponent* WakingComponent, FName BoneName)
 {
-	// Object moving: reactivate needs
-	SetComponentTickEnabled(true); // Start monitoring speed for CCD
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("PhysicsProps_Wake", PhysicsPropsChannel);
 
+	// Object moving: reactivate needs (CCD monitoring is done by the subsystem)
 	GetOwner()->SetActorTickEnabled(true);
+
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		PropSubsystem->SetPropAwake(this, true);
+	}
     
 	if (GetOwnerRole() == ROLE_Authority)
 	{
-		GetOwner()->SetReplicateMovement(true);
+		if (bQuantizedReplication)
+		{
+			SetNetAwake(true);
+		}
+		else
+		{
+			GetOwner()->SetReplicateMovement(true);
+		}
 	}
 }
 
-void UPhysicsPropComponent::OnTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+void UPhysicsPropComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	if (!ManagedMesh || !ManagedMesh->IsSimulatingPhysics()) return;
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	// Any damage wakes object, even if "lulled"
-	ManagedMesh->SetComponentTickInterval(0.0f); // Reset normal tick rate immediately
+	DOREPLIFETIME(UPhysicsPropComponent, NetState);
+}
 
-	// Unified DamageType handling
-	float ForceMultiplier = 500.0f;
-	bool bShouldWake = true;
+void UPhysicsPropComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// Called at the owner's net update rate only, and never while it is net dormant
+	if (bQuantizedReplication && ManagedMesh)
+	{
+		NetState.Capture(
+			ManagedMesh->GetComponentTransform(),
+			ManagedMesh->GetPhysicsLinearVelocity(),
+			ManagedMesh->GetPhysicsAngularVelocityInDegrees(),
+			bIsGrabbed || ManagedMesh->IsAnyRigidBodyAwake()
+		);
+	}
+}
+
+void UPhysicsPropComponent::SetNetAwake(bool bAwake)
+{
+	AActor* Owner = GetOwner();
+	if (!Owner || !ManagedMesh || !Owner->GetIsReplicated() || GetOwnerRole() != ROLE_Authority) return;
+
+	if (bAwake)
+	{
+		const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+		Owner->SetNetUpdateFrequency(PhysicsLOD == EPropPhysicsLOD::Reduced ? Settings->NetUpdateFrequencyReduced : Settings->NetUpdateFrequencyFull);
+		Owner->SetNetDormancy(DORM_Awake);
+	}
+	else
+	{
+		// Rest state, sent one last time before the actor goes dormant
+		NetState.Capture(ManagedMesh->GetComponentTransform(), FVector::ZeroVector, FVector::ZeroVector, false);
+
+		if (Owner->NetDormancy == DORM_DormantAll)
+		{
+			// Already dormant (e.g. Frozen prop falling asleep): push the new rest state anyway
+			Owner->FlushNetDormancy();
+		}
+		else
+		{
+			Owner->SetNetDormancy(DORM_DormantAll);
+		}
+	}
+}
+
+void UPhysicsPropComponent::OnRep_NetState()
+{
+	PhysicalizeDeferred();
+
+	if (!ManagedMesh || GetOwnerRole() == ROLE_Authority) return;
+
+	// The prop moves on the server, show it here whatever our local LOD
+	PromoteToFullLOD();
+
+	ManagedMesh->SetWorldLocationAndRotation(NetState.Location, NetState.GetRotation(), false, nullptr, ETeleportType::TeleportPhysics);
+
+	if (NetState.bAwake)
+	{
+		ManagedMesh->SetPhysicsLinearVelocity(NetState.LinearVelocity);
+		ManagedMesh->SetPhysicsAngularVelocityInDegrees(NetState.AngularVelocity);
+	}
+	else
+	{
+		ManagedMesh->PutRigidBodyToSleep();
+	}
+}
+
+void UPhysicsPropComponent::ApplyPropState(const FPropStateRecord& Record)
+{
+	if (!ManagedMesh) return;
+
+	ManagedMesh->SetWorldLocationAndRotation(Record.Location, Record.Rotation, false, nullptr, ETeleportType::ResetPhysics);
+
+	if (!ManagedMesh->IsSimulatingPhysics()) return;
+
+	if (Record.bAwake)
+	{
+		ManagedMesh->SetPhysicsLinearVelocity(Record.LinearVelocity);
+		ManagedMesh->SetPhysicsAngularVelocityInDegrees(Record.AngularVelocity);
+		ManagedMesh->WakeRigidBody();
+	}
+	else
+	{
+		// Start asleep right away instead of settling again, and run the sleep path (tick, dormancy)
+		ManagedMesh->PutRigidBodyToSleep();
+		OnPhysicsComponentSleep(ManagedMesh, NAME_None);
+	}
+}
+
+const FPropDamageResponse& UPhysicsPropComponent::GetDamageResponse(const UDamageType* DamageType, FPropDamageResponse& Fallback) const
+{
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		return PropSubsystem->GetDamageResponse(DamageType);
+	}
+
+	Fallback = FPropDamageResponse::Resolve(DamageType);
+	return Fallback;
+}
+
+void UPhysicsPropComponent::AddDamageImpulse(const FVector& VelocityChange, const FVector& Impulse, const FVector& AngularImpulse, bool bWake)
+{
+	// Strong enough to split the welded stack this prop belongs to, weaker damage doesn't move it
+	if (WeldGroup != INDEX_NONE)
+	{
+		if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+		{
+			const float Mass = ManagedMesh->GetMass();
+			const FVector TotalVelocityChange = VelocityChange + (Mass > 0.0f ? Impulse / Mass : Impulse);
+			PropSubsystem->BreakWeldOnImpulse(this, ManagedMesh->GetComponentLocation(), TotalVelocityChange.Size());
+		}
+	}
+
+	PendingDamageVelocityChange += VelocityChange;
+	PendingDamageImpulse += Impulse;
+	PendingDamageAngularImpulse += AngularImpulse;
+	bPendingDamageWake |= bWake;
 
-	if (const UPhysicsPropDamageType* JamDmg = Cast<UPhysicsPropDamageType>(DamageType))
+	if (!GetDefault<UPhysicsPropSettings>()->bCoalesceDamageImpulses)
 	{
-		bShouldWake = JamDmg->bForceWake;
-		ForceMultiplier = JamDmg->ImpulsePower;
+		FlushDamageImpulses();
+		return;
 	}
-	else if (const UGenericDamageType* GenDmg = Cast<UGenericDamageType>(DamageType))
+
+	// Applied at the end of the frame, together with the other damage events of this frame
+	if (!bDamageFlushQueued)
 	{
-		// Use GenericDamageType modifier on standard base
-		ForceMultiplier = 500.0f * GenDmg->ImpulseModifier;
+		if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+		{
+			bDamageFlushQueued = true;
+			PropSubsystem->QueueDamageFlush(this);
+		}
+		else
+		{
+			FlushDamageImpulses();
+		}
 	}
+}
+
+void UPhysicsPropComponent::FlushDamageImpulses()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_FlushDamage);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropComponent::FlushDamageImpulses);
+	PHYSICSPROP_TIMING_SCOPE(FlushDamage);
 
-	if (bShouldWake)
+	bDamageFlushQueued = false;
+
+	// Applied at the next physics step by the physics thread callback
+	FPropPhysicsCallback* PhysicsCallback = GetPhysicsCallback();
+	FSingleParticlePhysicsProxy* Proxy = GetPhysicsProxy();
+	if (PhysicsCallback && Proxy && ManagedMesh->IsSimulatingPhysics())
+	{
+		FPropImpulseCommand Command;
+		Command.Proxy = Proxy;
+		Command.VelocityChange = PendingDamageVelocityChange;
+		Command.Impulse = PendingDamageImpulse;
+		Command.AngularImpulse = PendingDamageAngularImpulse;
+		Command.bWake = bPendingDamageWake;
+		PhysicsCallback->AddImpulses_External(Command);
+	}
+	else if (ManagedMesh && ManagedMesh->IsSimulatingPhysics())
 	{
-		ManagedMesh->WakeAllRigidBodies();
+		if (bPendingDamageWake)
+		{
+			ManagedMesh->WakeAllRigidBodies();
+		}
+
+		if (!PendingDamageVelocityChange.IsNearlyZero())
+		{
+			ManagedMesh->AddImpulse(PendingDamageVelocityChange, NAME_None, true);
+		}
+		if (!PendingDamageImpulse.IsNearlyZero())
+		{
+			ManagedMesh->AddImpulse(PendingDamageImpulse, NAME_None, false);
+		}
+		if (!PendingDamageAngularImpulse.IsNearlyZero())
+		{
+			ManagedMesh->AddAngularImpulseInRadians(PendingDamageAngularImpulse, NAME_None, false);
+		}
 	}
 
+	PendingDamageVelocityChange = FVector::ZeroVector;
+	PendingDamageImpulse = FVector::ZeroVector;
+	PendingDamageAngularImpulse = FVector::ZeroVector;
+	bPendingDamageWake = false;
+}
+
+void UPhysicsPropComponent::OnTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_Damage);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropComponent::OnTakeAnyDamage);
+	PHYSICSPROP_TIMING_SCOPE(Damage);
+
+	// Still waiting in the registration queue
+	PhysicalizeDeferred();
+
+	// Damage brings frozen or dormant props back to life
+	PromoteToFullLOD();
+
+	// Welded props have no body of their own, strong enough damage splits their group
+	if (!ManagedMesh || (!ManagedMesh->IsSimulatingPhysics() && WeldGroup == INDEX_NONE)) return;
+
+	// Any damage wakes object, even if "lulled"
+	ManagedMesh->SetComponentTickInterval(0.0f); // Reset normal tick rate immediately
+
+	// Unified DamageType handling
+	FPropDamageResponse Fallback;
+	const FPropDamageResponse& Response = GetDamageResponse(DamageType, Fallback);
+
 	// Calculate impulse direction
 	FVector ImpulseDir = FVector::ZeroVector;
 
@@ -344,74 +1007,65 @@ void UPhysicsPropComponent::OnTakeAnyDamage(AActor* DamagedActor, float Damage,
 		ImpulseDir = FVector::UpVector;
 	}
 
-	const FVector Impulse = ImpulseDir * (Damage * ForceMultiplier);
-	// Apple to center of mass because we don't have HitLocation in AnyDamage
-	ManagedMesh->AddImpulse(Impulse, NAME_None, true); // true = Vel Change? No, standard Impulse.
+	// Apply to center of mass because we don't have HitLocation in AnyDamage (velocity change)
+	AddDamageImpulse(ImpulseDir * (Damage * Response.AnyDamageMultiplier), FVector::ZeroVector, FVector::ZeroVector, Response.bShouldWake);
 }
 
 void UPhysicsPropComponent::OnTakePointDamage(AActor* DamagedActor, float Damage, AController* InstigatedBy, FVector HitLocation, UPrimitiveComponent* FHitComponent, FName BoneName, FVector ShotFromDirection, const UDamageType* DamageType, AActor* DamageCauser)
 {
-	if (!ManagedMesh || !ManagedMesh->IsSimulatingPhysics()) return;
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_Damage);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropComponent::OnTakePointDamage);
+	PHYSICSPROP_TIMING_SCOPE(Damage);
 
-	float ForceMultiplier = 500.0f;
-	bool bShouldWake = true;
+	PhysicalizeDeferred();
+	PromoteToFullLOD();
 
-	if (const UPhysicsPropDamageType* JamDmg = Cast<UPhysicsPropDamageType>(DamageType))
-	{
-		bShouldWake = JamDmg->bForceWake;
-		ForceMultiplier = JamDmg->ImpulsePower;
-	}
-	else if (const UGenericDamageType* GenDmg = Cast<UGenericDamageType>(DamageType))
-	{
-		ForceMultiplier = 500.0f * GenDmg->ImpulseModifier;
-	}
+	// Welded props have no body of their own, strong enough damage splits their group
+	if (!ManagedMesh || (!ManagedMesh->IsSimulatingPhysics() && WeldGroup == INDEX_NONE)) return;
 
-	if (bShouldWake)
-	{
-		ManagedMesh->WakeAllRigidBodies();
-	}
-	
-	const FVector Impulse = ShotFromDirection * (Damage * ForceMultiplier);
-	
-	ManagedMesh->AddImpulseAtLocation(Impulse, HitLocation, BoneName);
+	FPropDamageResponse Fallback;
+	const FPropDamageResponse& Response = GetDamageResponse(DamageType, Fallback);
+
+	const FVector Impulse = ShotFromDirection * (Damage * Response.PointDamageMultiplier);
+
+	// Same as AddImpulseAtLocation: linear impulse plus the torque of its offset to the center of mass
+	const FVector AngularImpulse = FVector::CrossProduct(HitLocation - ManagedMesh->GetCenterOfMass(), Impulse);
+
+	AddDamageImpulse(FVector::ZeroVector, Impulse, AngularImpulse, Response.bShouldWake);
 }
 
 void UPhysicsPropComponent::OnTakeRadialDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, FVector Origin, const FHitResult& HitInfo, AController* InstigatedBy, AActor* DamageCauser)
 {
-	if (!ManagedMesh || !ManagedMesh->IsSimulatingPhysics()) return;
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_Damage);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropComponent::OnTakeRadialDamage);
+	PHYSICSPROP_TIMING_SCOPE(Damage);
 
-	float ForceMultiplier = 2000.0f;
-	bool bShouldWake = true;
+	PhysicalizeDeferred();
+	PromoteToFullLOD();
 
-	if (const UPhysicsPropDamageType* JamDmg = Cast<UPhysicsPropDamageType>(DamageType))
-	{
-		bShouldWake = JamDmg->bForceWake;
-		ForceMultiplier = JamDmg->ImpulsePower * 4.0f;
-	}
-	else if (const UGenericDamageType* GenDmg = Cast<UGenericDamageType>(DamageType))
-	{
-		ForceMultiplier = 2000.0f * GenDmg->ImpulseModifier;
-	}
+	// Welded props have no body of their own, strong enough damage splits their group
+	if (!ManagedMesh || (!ManagedMesh->IsSimulatingPhysics() && WeldGroup == INDEX_NONE)) return;
+
+	FPropDamageResponse Fallback;
+	const FPropDamageResponse& Response = GetDamageResponse(DamageType, Fallback);
 
-	if (bShouldWake)
+	// Damage is already scaled by the falloff of the radial damage, push away from the origin.
+	// A radial impulse would need the real damage radius, which this event doesn't provide.
+	FVector ImpulseDir = (ManagedMesh->GetComponentLocation() - Origin).GetSafeNormal();
+	if (ImpulseDir.IsNearlyZero())
 	{
-		ManagedMesh->WakeAllRigidBodies();
+		ImpulseDir = FVector::UpVector;
 	}
 
-	const float ImpulseStrength = Damage * ForceMultiplier;
-	
-	ManagedMesh->AddRadialImpulse(Origin, 500.0f, ImpulseStrength, ERadialImpulseFalloff::RIF_Linear, true);
+	AddDamageImpulse(ImpulseDir * (Damage * Response.RadialDamageMultiplier), FVector::ZeroVector, FVector::ZeroVector, Response.bShouldWake);
 }
 
 void UPhysicsPropComponent::OnComponentHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
-	if (!ImpactTable || !GetWorld()) return;
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_ComponentHit);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropComponent::OnComponentHit);
+	PHYSICSPROP_TIMING_SCOPE(ComponentHit);
 
-	// 1. Anti-spam: Time cooldown
-	const float CurrentTime = GetWorld()->GetTimeSeconds();
-	if (CurrentTime - LastImpactTime < ImpactCooldown) return;
-
-	// 2. Calculate impact force (Normal Impulse)
 	// NormalImpulse depends on mass. To get a "normalized" value close to velocity, divide by mass.
 	float ImpactIntensity = NormalImpulse.Size();
     
@@ -421,33 +1075,60 @@ void UPhysicsPropComponent::OnComponentHit(UPrimitiveComponent* HitComponent, AA
 	{
 		ImpactIntensity /= ManagedMesh->GetMass(); 
 	}
-	
-	// Min threshold to play sound (avoid noise when rolling gently or vibrating)
-	if (ImpactIntensity < MinImpactThreshold) return;
 
-	// 3. Get Physical Material of touched surface
-	UPhysicalMaterial* HitPhysMat = Hit.PhysMaterial.Get();
-    
-	// 4. Find sound in table
-	const FImpactSoundEntry* SoundEntry = ImpactTable->ImpactMap.Find(HitPhysMat);
-	
-	// If no specific sound, use default
-	if (!SoundEntry) 
+	// Hits on a welded stack are reported on the body of its first prop
+	if (WeldGroup != INDEX_NONE)
 	{
-		SoundEntry = &ImpactTable->DefaultSound;
+		if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+		{
+			PropSubsystem->BreakWeldOnImpulse(this, Hit.ImpactPoint, ImpactIntensity);
+		}
 	}
 
-	if (SoundEntry && SoundEntry->ImpactSound)
+	HandleImpact(ImpactIntensity, Hit.ImpactPoint, Hit.ImpactNormal, Hit.PhysMaterial.Get());
+}
+
+void UPhysicsPropComponent::HandleImpact(float ImpactIntensity, const FVector& Location, const FVector& Normal, const UPhysicalMaterial* HitMaterial)
+{
+	if (!ImpactTable || !GetWorld()) return;
+
+	// 1. Anti-spam: Time cooldown
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (CurrentTime - LastImpactTime < ImpactCooldown) return;
+
+	// Per-prop rate limit
+	if (CurrentTime - ImpactWindowStart >= 1.0f)
 	{
-		// 5. Volume Normalization (Source style)
-		// Map intensity (e.g., 100 to 1500) to volume (0.2 to 1.0)
-		// These "Magic Numbers" (1500.0f) depend on game scale, need tuning.
-		const float Volume = FMath::GetMappedRangeValueClamped(FVector2D(MinImpactThreshold, MinImpactThreshold * 5.0f), FVector2D(0.2f, 1.0f), ImpactIntensity) * SoundEntry->VolumeMultiplier;		
-		// Pitch variation to avoid robotic repetition (0.85 - 1.1)
-		const float Pitch = FMath::RandRange(0.85f, 1.1f); 
+		ImpactWindowStart = CurrentTime;
+		NumImpactsInWindow = 0;
+	}
+	if (MaxImpactsPerSecond > 0 && NumImpactsInWindow >= MaxImpactsPerSecond) return;
+
+	// 2. Min threshold to play sound (avoid noise when rolling gently or vibrating)
+	if (ImpactIntensity < MinImpactThreshold) return;
+
+	// 3. Find entry in table (fallbacks are resolved when the table is compiled)
+	ImpactTable->ConditionalCompileImpactTable();
+	const FImpactSoundEntry& Entry = ImpactTable->FindImpactSound(PropSurface, HitMaterial);
+
+	if (Entry.ImpactSound.IsNull() && !Entry.ImpactVFX && !Entry.ImpactDecal) return;
 
-		UGameplayStatics::PlaySoundAtLocation(this, SoundEntry->ImpactSound, Hit.ImpactPoint, Volume, Pitch);
-        
-		LastImpactTime = CurrentTime;
+	// 4. Volume Normalization (Source style)
+	// Map intensity (e.g., 100 to 1500) to volume (0.2 to 1.0)
+	// These "Magic Numbers" (1500.0f) depend on game scale, need tuning.
+	const float Strength = FMath::GetMappedRangeValueClamped(FVector2D(MinImpactThreshold, MinImpactThreshold * 5.0f), FVector2D(0.2f, 1.0f), ImpactIntensity);
+
+	// Played and spawned at the end of the frame by the global scheduler and spawner, within their budgets
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		// Not streamed in yet (bank still loading): silent, never a blocking load
+		if (USoundBase* Sound = Entry.ImpactSound.Get())
+		{
+			PropSubsystem->GetImpactAudio().QueueImpact(Sound, Location, Strength * Entry.VolumeMultiplier);
+		}
+		PropSubsystem->GetImpactVFX().QueueImpact(Entry, Location, Normal, Strength);
 	}
+
+	LastImpactTime = CurrentTime;
+	++NumImpactsInWindow;
 }
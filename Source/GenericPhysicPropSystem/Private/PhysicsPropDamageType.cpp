@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PhysicsPropDamageType.h"
+#include "GenericDamageType.h"
+
+float UPhysicsPropDamageType::ResolveImpulseMultiplier(const UDamageType* DamageType, float BaseMultiplier, float PropDamageScale, bool& bOutShouldWake)
+{
+	bOutShouldWake = true;
+
+	if (const UPhysicsPropDamageType* JamDmg = Cast<UPhysicsPropDamageType>(DamageType))
+	{
+		bOutShouldWake = JamDmg->bForceWake;
+		return JamDmg->ImpulsePower * PropDamageScale;
+	}
+
+	if (const UGenericDamageType* GenDmg = Cast<UGenericDamageType>(DamageType))
+	{
+		// Use GenericDamageType modifier on standard base
+		return BaseMultiplier * GenDmg->ImpulseModifier;
+	}
+
+	return BaseMultiplier;
+}
+
+FPropDamageResponse FPropDamageResponse::Resolve(const UDamageType* DamageType)
+{
+	FPropDamageResponse Response;
+	Response.AnyDamageMultiplier = UPhysicsPropDamageType::ResolveImpulseMultiplier(DamageType, 500.0f, 1.0f, Response.bShouldWake);
+	Response.PointDamageMultiplier = UPhysicsPropDamageType::ResolveImpulseMultiplier(DamageType, 500.0f, 1.0f, Response.bShouldWake);
+	Response.RadialDamageMultiplier = UPhysicsPropDamageType::ResolveImpulseMultiplier(DamageType, 2000.0f, 4.0f, Response.bShouldWake);
+	return Response;
+}
@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PhysicsPropSettings.h"
+
+UPhysicsPropSettings::UPhysicsPropSettings()
+{
+	CategoryName = TEXT("Plugins");
+	SectionName = TEXT("GenericPhysicPropSystem");
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PhysicsPropStats.h"
+
+DEFINE_STAT(STAT_PhysicsProps_NumAwake);
+DEFINE_STAT(STAT_PhysicsProps_NumAsleep);
+DEFINE_STAT(STAT_PhysicsProps_NumCulled);
+DEFINE_STAT(STAT_PhysicsProps_CCDToggles);
+DEFINE_STAT(STAT_PhysicsProps_ImpactSoundsPlayed);
+DEFINE_STAT(STAT_PhysicsProps_ImpactSoundsRejected);
+DEFINE_STAT(STAT_PhysicsProps_ImpactVFXSpawned);
+DEFINE_STAT(STAT_PhysicsProps_ImpactVFXRejected);
+DEFINE_STAT(STAT_PhysicsProps_NumSoundBanks);
+DEFINE_STAT(STAT_PhysicsProps_NumWelded);
+DEFINE_STAT(STAT_PhysicsProps_NumSimpleCollision);
+DEFINE_STAT(STAT_PhysicsProps_NumPendingRegistrations);
+DEFINE_STAT(STAT_PhysicsProps_GrabSweeps);
+
+CSV_DEFINE_CATEGORY_MODULE(GENERICPHYSICPROPSYSTEM_API, PhysicsProps, true);
+
+UE_TRACE_CHANNEL_DEFINE(PhysicsPropsChannel);
+
+#if PHYSICSPROP_WITH_TIMINGS
+
+bool FPhysicsPropTimings::bEnabled = false;
+double FPhysicsPropTimings::Seconds[(int32)EPhysicsPropTiming::Num] = {};
+int32 FPhysicsPropTimings::Calls[(int32)EPhysicsPropTiming::Num] = {};
+
+void FPhysicsPropTimings::Reset()
+{
+	for (int32 Index = 0; Index < (int32)EPhysicsPropTiming::Num; ++Index)
+	{
+		Seconds[Index] = 0.0;
+		Calls[Index] = 0;
+	}
+}
+
+const TCHAR* FPhysicsPropTimings::GetName(EPhysicsPropTiming Timing)
+{
+	switch (Timing)
+	{
+	case EPhysicsPropTiming::SubsystemTick:			return TEXT("SubsystemTick");
+	case EPhysicsPropTiming::CCDPass:				return TEXT("CCDPass");
+	case EPhysicsPropTiming::LODPass:				return TEXT("LODPass");
+	case EPhysicsPropTiming::LODTransitions:		return TEXT("LODTransitions");
+	case EPhysicsPropTiming::WeldPass:				return TEXT("WeldPass");
+	case EPhysicsPropTiming::ApplyExplosion:		return TEXT("ApplyExplosion");
+	case EPhysicsPropTiming::NetReplication:		return TEXT("NetReplication");
+	case EPhysicsPropTiming::NetInterpolation:		return TEXT("NetInterpolation");
+	case EPhysicsPropTiming::Registration:			return TEXT("Registration");
+	case EPhysicsPropTiming::ComponentTick:			return TEXT("ComponentTick");
+	case EPhysicsPropTiming::UpdateGrabbedPosition:	return TEXT("UpdateGrabbedPosition");
+	case EPhysicsPropTiming::ComponentHit:			return TEXT("ComponentHit");
+	case EPhysicsPropTiming::CollisionEvents:		return TEXT("CollisionEvents");
+	case EPhysicsPropTiming::Damage:				return TEXT("Damage");
+	case EPhysicsPropTiming::FlushDamage:			return TEXT("FlushDamage");
+	default:										return TEXT("Unknown");
+	}
+}
+
+#endif
@@ -0,0 +1,2058 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PhysicsPropSubsystem.h"
+#include "PhysicsPropComponent.h"
+#include "PhysicsPropSettings.h"
+#include "PhysicsPropDamageType.h"
+#include "PropReplicationManager.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PBDRigidsSolver.h"
+#include "EventManager.h"
+#include "EventsData.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "PhysicsPropStats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPhysicsProps, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("Subsystem Tick"), STAT_PhysicsProps_SubsystemTick, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("CCD Pass"), STAT_PhysicsProps_CCDPass, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("LOD Pass"), STAT_PhysicsProps_LODPass, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("LOD Transitions"), STAT_PhysicsProps_LODTransitions, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Weld Pass"), STAT_PhysicsProps_WeldPass, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Apply Explosion"), STAT_PhysicsProps_ApplyExplosion, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Net Replication"), STAT_PhysicsProps_NetReplication, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Collision Events"), STAT_PhysicsProps_CollisionEvents, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Deferred Registration"), STAT_PhysicsProps_Registration, STATGROUP_PhysicsProps);
+DECLARE_CYCLE_STAT(TEXT("Net Interpolation"), STAT_PhysicsProps_NetInterpolation, STATGROUP_PhysicsProps);
+
+void UPhysicsPropSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Grid.SetCellSize(GetDefault<UPhysicsPropSettings>()->GridCellSize);
+}
+
+void UPhysicsPropSubsystem::Deinitialize()
+{
+	if (PhysicsCallback)
+	{
+		FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+		if (Chaos::FPhysicsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr)
+		{
+			Solver->UnregisterAndFreeSimCallbackObject_External(PhysicsCallback);
+		}
+		PhysicsCallback = nullptr;
+	}
+
+	if (bCollisionEventsRegistered)
+	{
+		FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+		if (Chaos::FPhysicsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr)
+		{
+			Solver->GetEventManager()->UnregisterHandler(Chaos::EEventType::Collision, this);
+		}
+		bCollisionEventsRegistered = false;
+	}
+
+	for (UPhysicsPropComponent* Prop : Props)
+	{
+		if (Prop)
+		{
+			Prop->PropIndex = INDEX_NONE;
+		}
+	}
+	WeldGroups.Reset();
+	NumWeldedProps = 0;
+	Props.Reset();
+	PosX.Reset();
+	PosY.Reset();
+	PosZ.Reset();
+	CullDistSq.Reset();
+	CCDThresholdSq.Reset();
+	StateFlags.Reset();
+	GridCells.Reset();
+	NearestDistSq.Reset();
+	BoundsRadius.Reset();
+	LODScreenSizes.Reset();
+	LODDistSq.Reset();
+	LODTiers.Reset();
+	DesiredLODTiers.Reset();
+	Grid.Reset();
+	MaxCullDistance = 0.0f;
+	bMaxCullDistanceDirty = false;
+	for (const TWeakObjectPtr<UPhysicsPropComponent>& Prop : PendingRegistrations)
+	{
+		if (Prop.IsValid())
+		{
+			Prop->RegistrationSlot = INDEX_NONE;
+		}
+	}
+	PendingRegistrations.Reset();
+	NextRegistration = 0;
+	PendingLODTransitions.Reset();
+	NextLODTransition = 0;
+	PendingHibernations.Reset();
+	PendingCollisionSwaps.Reset();
+	SimpleCollisionSetups.Reset();
+	PendingDamageFlushes.Reset();
+	DamageResponses.Reset();
+	ProxyBatches.Reset();
+	ProxyActor = nullptr;
+	InterestSources.Reset();
+	Observers.Reset();
+	OutOfWorldActors.Reset();
+	KillVolumes.Reset();
+	PendingBakedStates.Reset();
+	Pools.Reset();
+	ImpactAudio.Reset();
+	ImpactVFX.Reset();
+	ImpactSoundBanks.Reset();
+	ReplicationManager = nullptr;
+	PropsByNetId.Reset();
+	PropsByStableId.Reset();
+	CollidingStableIds.Reset();
+	NetTargets.Reset();
+	PropsByMesh.Reset();
+
+	Super::Deinitialize();
+}
+
+void UPhysicsPropSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Only servers with clients to feed need the manager
+	const ENetMode NetMode = InWorld.GetNetMode();
+	if (GetDefault<UPhysicsPropSettings>()->bAggregatedReplication && NetMode != NM_Client && NetMode != NM_Standalone)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		ReplicationManager = InWorld.SpawnActor<APropReplicationManager>(SpawnParams);
+	}
+
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+	FPhysScene* PhysScene = InWorld.GetPhysicsScene();
+	Chaos::FPhysicsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr;
+	if (Settings->bPhysicsThreadCallback && Solver)
+	{
+		PhysicsCallback = Solver->CreateAndRegisterSimCallbackObject_External<FPropPhysicsCallback>();
+	}
+
+	// Impacts make sounds and effects, nobody listens on a dedicated server. It still needs the contacts to break welds.
+	if (Settings->bBatchedImpactEvents && (NetMode != NM_DedicatedServer || Settings->bEnableWelding) && Solver)
+	{
+		Solver->SetGenerateCollisionData(true);
+
+		// Slow contacts never leave the physics thread
+		if (Settings->ImpactEventMinSpeed > 0.0f)
+		{
+			FSolverCollisionFilterSettings FilterSettings;
+			FilterSettings.FilterEnabled = true;
+			FilterSettings.MinMass = 0.0f;
+			FilterSettings.MinSpeed = Settings->ImpactEventMinSpeed;
+			FilterSettings.MinImpulse = 0.0f;
+			Solver->SetCollisionFilterSettings(FilterSettings);
+		}
+
+		Solver->GetEventManager()->RegisterHandler<Chaos::FCollisionEventData>(Chaos::EEventType::Collision, this, &UPhysicsPropSubsystem::HandleCollisionEvents);
+		bCollisionEventsRegistered = true;
+	}
+}
+
+void UPhysicsPropSubsystem::HandleCollisionEvents(const Chaos::FCollisionEventData& CollisionData)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_CollisionEvents);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::HandleCollisionEvents);
+	PHYSICSPROP_TIMING_SCOPE(CollisionEvents);
+
+	FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+	if (!PhysScene || PropsByMesh.Num() == 0) return;
+
+	const bool bPlayImpacts = GetWorld()->GetNetMode() != NM_DedicatedServer;
+
+	for (const Chaos::FCollidingData& Contact : CollisionData.CollisionData.AllCollisionsArray)
+	{
+		const UPrimitiveComponent* Component1 = PhysScene->GetOwningComponent<UPrimitiveComponent>(Contact.Proxy1);
+		const UPrimitiveComponent* Component2 = PhysScene->GetOwningComponent<UPrimitiveComponent>(Contact.Proxy2);
+
+		// Each prop of the pair gets its own impact, normalized by its own mass
+		const float Impulse = (float)Contact.AccumulatedImpulse.Size();
+		const auto HandleSide = [this, &Contact, Impulse, bPlayImpacts](const UPrimitiveComponent* PropMesh, const UPrimitiveComponent* OtherMesh, Chaos::FReal Mass)
+		{
+			UPhysicsPropComponent* const* Prop = PropMesh ? PropsByMesh.Find(PropMesh) : nullptr;
+			if (!Prop) return;
+
+			// Contacts of a welded stack are reported on the body of its first prop
+			const float Intensity = Mass > 0.0f ? Impulse / (float)Mass : Impulse;
+			if ((*Prop)->WeldGroup != INDEX_NONE)
+			{
+				BreakWeldOnImpulse(*Prop, FVector(Contact.Location), Intensity);
+			}
+
+			if (!bPlayImpacts || !(*Prop)->ImpactTable) return;
+
+			const FBodyInstance* OtherBody = OtherMesh ? OtherMesh->GetBodyInstance() : nullptr;
+			(*Prop)->HandleImpact(Intensity, FVector(Contact.Location), FVector(Contact.Normal), OtherBody ? OtherBody->GetSimplePhysicalMaterial() : nullptr);
+		};
+
+		HandleSide(Component1, Component2, Contact.Mass1);
+		HandleSide(Component2, Component1, Contact.Mass2);
+	}
+}
+
+void UPhysicsPropSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	// Pooled impact components aren't owned by any actor
+	CastChecked<UPhysicsPropSubsystem>(InThis)->ImpactVFX.AddReferencedObjects(Collector);
+}
+
+bool UPhysicsPropSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UPhysicsPropSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPhysicsPropSubsystem, STATGROUP_PhysicsProps);
+}
+
+void UPhysicsPropSubsystem::RegisterProp(UPhysicsPropComponent* Prop)
+{
+	if (!Prop || !Prop->ManagedMesh || Prop->PropIndex != INDEX_NONE) return;
+
+	Prop->PropIndex = Props.Add(Prop);
+
+	const FVector Location = Prop->ManagedMesh->GetComponentLocation();
+	PosX.Add(Location.X);
+	PosY.Add(Location.Y);
+	PosZ.Add(Location.Z);
+	CullDistSq.Add(Prop->PhysicsCullDistance > 0.0f ? FMath::Square(Prop->PhysicsCullDistance) : FLT_MAX);
+	CCDThresholdSq.Add(Prop->CCDSpeedThreshold > 0.0f ? FMath::Square(Prop->CCDSpeedThreshold) : FLT_MAX);
+	StateFlags.Add((Prop->ManagedMesh->RigidBodyIsAwake() ? PSF_Awake : PSF_None) | (Prop->ManagedMesh->BodyInstance.bUseCCD ? PSF_CCD : PSF_None));
+	GridCells.Add(Grid.Add(Prop->PropIndex, Location));
+	NearestDistSq.Add(FLT_MAX);
+	BoundsRadius.Add(Prop->ManagedMesh->Bounds.SphereRadius);
+	LODTiers.Add(static_cast<uint8>(Prop->PhysicsLOD));
+	DesiredLODTiers.Add(static_cast<uint8>(Prop->PhysicsLOD));
+
+	MaxCullDistance = FMath::Max(MaxCullDistance, Prop->PhysicsCullDistance);
+
+	// 32-bit path hashes can collide in large levels: both props lose their ID rather than get each other's state
+	if (Prop->StableId != 0)
+	{
+		UPhysicsPropComponent* Other = PropsByStableId.FindRef(Prop->StableId);
+		if (Other || CollidingStableIds.Contains(Prop->StableId))
+		{
+			if (Other)
+			{
+				UE_LOG(LogPhysicsProps, Warning, TEXT("Physics props %s and %s have the same stable ID, they are left out of snapshots and aggregated replication."),
+					*GetPathNameSafe(Other->GetOwner()), *GetPathNameSafe(Prop->GetOwner()));
+				CollidingStableIds.Add(Prop->StableId);
+				PropsByStableId.Remove(Prop->StableId);
+				ExcludeStableId(Other);
+			}
+			ExcludeStableId(Prop);
+		}
+		else
+		{
+			PropsByStableId.Add(Prop->StableId, Prop);
+		}
+	}
+
+	if (Prop->NetId != 0)
+	{
+		PropsByNetId.Add(Prop->NetId, Prop);
+	}
+	PropsByMesh.Add(Prop->ManagedMesh, Prop);
+
+	// Baked rest state waiting for this prop
+	FPropStateRecord BakedState;
+	if (PendingBakedStates.Num() > 0 && PropsByStableId.FindRef(Prop->StableId) == Prop && PendingBakedStates.RemoveAndCopyValue(Prop->StableId, BakedState))
+	{
+		ApplyPropState(Prop, BakedState);
+	}
+}
+
+void UPhysicsPropSubsystem::QueueRegistration(UPhysicsPropComponent* Prop)
+{
+	if (!Prop) return;
+
+	Prop->RegistrationSlot = PendingRegistrations.Add(Prop);
+	bSortRegistrations = true;
+}
+
+void UPhysicsPropSubsystem::DequeueRegistration(UPhysicsPropComponent* Prop)
+{
+	if (!Prop || Prop->RegistrationSlot == INDEX_NONE) return;
+
+	// Cleared in place, the queue skips empty entries
+	if (PendingRegistrations.IsValidIndex(Prop->RegistrationSlot) && PendingRegistrations[Prop->RegistrationSlot].Get() == Prop)
+	{
+		PendingRegistrations[Prop->RegistrationSlot].Reset();
+	}
+	Prop->RegistrationSlot = INDEX_NONE;
+}
+
+void UPhysicsPropSubsystem::ProcessPendingRegistrations()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_Registration);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::ProcessPendingRegistrations);
+	PHYSICSPROP_TIMING_SCOPE(Registration);
+
+	// New props were queued (e.g. a sublevel streamed in): closest to an observer first
+	if (bSortRegistrations)
+	{
+		bSortRegistrations = false;
+		PendingRegistrations.RemoveAt(0, NextRegistration, EAllowShrinking::No);
+		NextRegistration = 0;
+
+		GatherObservers();
+		if (Observers.Num() > 0)
+		{
+			TArray<TPair<float, TWeakObjectPtr<UPhysicsPropComponent>>> SortedRegistrations;
+			SortedRegistrations.Reserve(PendingRegistrations.Num());
+			for (const TWeakObjectPtr<UPhysicsPropComponent>& Prop : PendingRegistrations)
+			{
+				float MinDistSq = FLT_MAX;
+				if (Prop.IsValid())
+				{
+					const FVector Location = Prop->GetOwner()->GetActorLocation();
+					for (const FVector& Observer : Observers)
+					{
+						MinDistSq = FMath::Min(MinDistSq, (float)FVector::DistSquared(Observer, Location));
+					}
+				}
+				SortedRegistrations.Emplace(MinDistSq, Prop);
+			}
+			SortedRegistrations.Sort([](const TPair<float, TWeakObjectPtr<UPhysicsPropComponent>>& A, const TPair<float, TWeakObjectPtr<UPhysicsPropComponent>>& B)
+			{
+				return A.Key < B.Key;
+			});
+
+			for (int32 Index = 0; Index < SortedRegistrations.Num(); ++Index)
+			{
+				PendingRegistrations[Index] = SortedRegistrations[Index].Value;
+			}
+		}
+
+		// Entries moved, props keep track of theirs to leave the queue
+		for (int32 Slot = 0; Slot < PendingRegistrations.Num(); ++Slot)
+		{
+			if (UPhysicsPropComponent* Prop = PendingRegistrations[Slot].Get())
+			{
+				Prop->RegistrationSlot = Slot;
+			}
+		}
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + GetDefault<UPhysicsPropSettings>()->RegistrationBudgetMs * 0.001;
+	do
+	{
+		if (UPhysicsPropComponent* Prop = PendingRegistrations[NextRegistration++].Get())
+		{
+			Prop->RegistrationSlot = INDEX_NONE;
+			Prop->PhysicalizeDeferred();
+		}
+	}
+	while (NextRegistration < PendingRegistrations.Num() && FPlatformTime::Seconds() < EndTime);
+
+	if (NextRegistration >= PendingRegistrations.Num())
+	{
+		PendingRegistrations.Reset();
+		NextRegistration = 0;
+	}
+}
+
+void UPhysicsPropSubsystem::UnregisterProp(UPhysicsPropComponent* Prop)
+{
+	if (!Prop || !Props.IsValidIndex(Prop->PropIndex) || Props[Prop->PropIndex] != Prop) return;
+
+	DissolveWeldGroup(Prop);
+
+	if (Prop->bHibernated)
+	{
+		RehydrateProp(Prop);
+	}
+
+	if (Prop->NetId != 0)
+	{
+		PropsByNetId.Remove(Prop->NetId);
+		NetTargets.Remove(Prop->NetId);
+		if (ReplicationManager)
+		{
+			ReplicationManager->RemoveProp(Prop->NetId);
+		}
+	}
+
+	PropsByMesh.Remove(Prop->ManagedMesh);
+
+	if (PropsByStableId.FindRef(Prop->StableId) == Prop)
+	{
+		PropsByStableId.Remove(Prop->StableId);
+	}
+
+	if (PhysicsCallback)
+	{
+		PhysicsCallback->SetCCDThreshold_External(Prop->CCDParticleId, 0.0f);
+		Prop->CCDParticleId = INDEX_NONE;
+	}
+
+	// The grid query radius shrinks back once the farthest-reaching prop is gone
+	if (Prop->PhysicsCullDistance >= MaxCullDistance)
+	{
+		bMaxCullDistanceDirty = true;
+	}
+
+	const int32 Index = Prop->PropIndex;
+	Grid.Remove(Index, GridCells[Index]);
+
+	// Swap-remove keeps the buffers packed; patch the index of the prop moved into the hole.
+	Props.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PosX.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PosY.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PosZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CullDistSq.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CCDThresholdSq.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	StateFlags.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GridCells.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	NearestDistSq.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	BoundsRadius.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	LODTiers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	DesiredLODTiers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (Props.IsValidIndex(Index))
+	{
+		Grid.Rename(Props.Num(), Index, GridCells[Index]);
+		if (Props[Index])
+		{
+			Props[Index]->PropIndex = Index;
+		}
+	}
+
+	Prop->PropIndex = INDEX_NONE;
+}
+
+void UPhysicsPropSubsystem::SetPropAwake(UPhysicsPropComponent* Prop, bool bAwake)
+{
+	if (!Prop || !Props.IsValidIndex(Prop->PropIndex)) return;
+
+	const int32 Index = Prop->PropIndex;
+	if (bAwake)
+	{
+		StateFlags[Index] |= PSF_Awake;
+
+		// The physics thread switches CCD for this body, which may have been recreated since the last wake
+		if (PhysicsCallback && CCDThresholdSq[Index] != FLT_MAX)
+		{
+			const FSingleParticlePhysicsProxy* Proxy = Prop->GetPhysicsProxy();
+			const int32 ParticleId = Proxy ? Proxy->GetGameThreadAPI().UniqueIdx().Idx : INDEX_NONE;
+			if (ParticleId != Prop->CCDParticleId)
+			{
+				PhysicsCallback->SetCCDThreshold_External(Prop->CCDParticleId, 0.0f);
+				PhysicsCallback->SetCCDThreshold_External(ParticleId, CCDThresholdSq[Index]);
+				Prop->CCDParticleId = ParticleId;
+			}
+		}
+	}
+	else
+	{
+		StateFlags[Index] &= ~PSF_Awake;
+
+		// Store the resting location: it won't change until the prop wakes up again
+		if (Prop->ManagedMesh)
+		{
+			SetPropLocation(Index, Prop->ManagedMesh->GetComponentLocation());
+
+			// Clients get the rest state before the prop leaves the replicated array
+			if (ReplicationManager && Prop->NetId != 0)
+			{
+				FPropNetState State;
+				State.Capture(Prop->ManagedMesh->GetComponentTransform(), FVector::ZeroVector, FVector::ZeroVector, false);
+				ReplicationManager->UpdatePropState(Prop->NetId, State, GetWorld()->GetTimeSeconds());
+			}
+		}
+	}
+
+	// Welded props have no body of their own, they sleep and move with the body of their group
+	if (WeldGroups.IsValidIndex(Prop->WeldGroup))
+	{
+		const TArray<UPhysicsPropComponent*>& Members = WeldGroups[Prop->WeldGroup].Members;
+		if (Members[0] == Prop)
+		{
+			for (int32 MemberIndex = 1; MemberIndex < Members.Num(); ++MemberIndex)
+			{
+				SetPropAwake(Members[MemberIndex], bAwake);
+			}
+		}
+	}
+}
+
+void UPhysicsPropSubsystem::NotifyPropLODChanged(UPhysicsPropComponent* Prop)
+{
+	if (!Prop || !Props.IsValidIndex(Prop->PropIndex)) return;
+
+	LODTiers[Prop->PropIndex] = static_cast<uint8>(Prop->PhysicsLOD);
+}
+
+const FPropDamageResponse& UPhysicsPropSubsystem::GetDamageResponse(const UDamageType* DamageType)
+{
+	const TObjectKey<UClass> DamageClass(DamageType ? DamageType->GetClass() : nullptr);
+	if (const FPropDamageResponse* Cached = DamageResponses.Find(DamageClass))
+	{
+		return *Cached;
+	}
+
+	// Damage types are used through their CDO, so the class decides the response
+	return DamageResponses.Add(DamageClass, FPropDamageResponse::Resolve(DamageType));
+}
+
+void UPhysicsPropSubsystem::QueueDamageFlush(UPhysicsPropComponent* Prop)
+{
+	PendingDamageFlushes.Add(Prop);
+}
+
+void UPhysicsPropSubsystem::RegisterInterestSource(AActor* Source)
+{
+	if (Source)
+	{
+		InterestSources.AddUnique(Source);
+	}
+}
+
+void UPhysicsPropSubsystem::UnregisterInterestSource(AActor* Source)
+{
+	InterestSources.Remove(Source);
+}
+
+FPropProxyBatch& UPhysicsPropSubsystem::GetOrCreateProxyBatch(UStaticMesh* Mesh, const UPhysicsPropComponent* Prop)
+{
+	FPropProxyBatch& Batch = ProxyBatches.FindOrAdd(Mesh);
+	if (Batch.Instances) return Batch;
+
+	if (!ProxyActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = MakeUniqueObjectName(GetWorld(), AActor::StaticClass(), TEXT("PhysicsPropProxies"));
+		SpawnParams.ObjectFlags |= RF_Transient;
+		ProxyActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		ProxyActor->SetRootComponent(NewObject<USceneComponent>(ProxyActor, TEXT("Root")));
+		ProxyActor->GetRootComponent()->RegisterComponent();
+	}
+
+	const UStaticMeshComponent* SourceMesh = Prop->ManagedMesh;
+
+	Batch.Instances = NewObject<UInstancedStaticMeshComponent>(ProxyActor);
+	Batch.Instances->SetStaticMesh(Mesh);
+
+	// Removing an instance moves the last one into its slot, instead of shifting every instance after it
+	Batch.Instances->bSupportRemoveAtSwap = true;
+
+	// Queries can still find the props (to rehydrate them), but nothing simulates against them
+	if (GetDefault<UPhysicsPropSettings>()->bHibernatedProxyCollision)
+	{
+		Batch.Instances->SetCollisionObjectType(SourceMesh->GetCollisionObjectType());
+		Batch.Instances->SetCollisionResponseToChannels(SourceMesh->GetCollisionResponseToChannels());
+		Batch.Instances->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	}
+	else
+	{
+		Batch.Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+
+	Batch.Instances->SetupAttachment(ProxyActor->GetRootComponent());
+	Batch.Instances->RegisterComponent();
+	return Batch;
+}
+
+UBodySetup* UPhysicsPropSubsystem::GetSimpleCollisionSetup(UStaticMesh* Mesh)
+{
+	if (!Mesh) return nullptr;
+	if (UBodySetup** Found = SimpleCollisionSetups.Find(Mesh))
+	{
+		return *Found;
+	}
+
+	UBodySetup* SimpleSetup = nullptr;
+	UBodySetup* Source = Mesh->GetBodySetup();
+
+	// Only hulls or several primitives have something to gain
+	if (Source && (Source->AggGeom.ConvexElems.Num() > 0 || Source->AggGeom.GetElementCount() > 1))
+	{
+		const FBox Box = Source->AggGeom.CalcAABB(FTransform::Identity);
+		const FVector Extent = Box.GetExtent();
+
+		// Same physical material and collision responses, new shapes
+		SimpleSetup = NewObject<UBodySetup>(this);
+		SimpleSetup->CopyBodyPropertiesFrom(Source);
+		SimpleSetup->AggGeom = FKAggregateGeom();
+		SimpleSetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+		SimpleSetup->bNeverNeedsCookedCollisionData = true;
+
+		// Round shapes filling little of their box (rocks, balls) keep rolling as spheres, the rest gets the box
+		const double BoxVolume = 8.0 * Extent.X * Extent.Y * Extent.Z;
+		const bool bRound = Extent.GetMin() >= Extent.GetMax() * 0.8 && Source->AggGeom.GetScaledVolume(FVector::OneVector) < BoxVolume * 0.7;
+		if (bRound)
+		{
+			FKSphereElem& Sphere = SimpleSetup->AggGeom.SphereElems.AddDefaulted_GetRef();
+			Sphere.Center = Box.GetCenter();
+			Sphere.Radius = (Extent.X + Extent.Y + Extent.Z) / 3.0f;
+		}
+		else
+		{
+			FKBoxElem& BoxElem = SimpleSetup->AggGeom.BoxElems.AddDefaulted_GetRef();
+			BoxElem.Center = Box.GetCenter();
+			BoxElem.X = Extent.X * 2.0f;
+			BoxElem.Y = Extent.Y * 2.0f;
+			BoxElem.Z = Extent.Z * 2.0f;
+		}
+	}
+
+	SimpleCollisionSetups.Add(Mesh, SimpleSetup);
+	return SimpleSetup;
+}
+
+void UPhysicsPropSubsystem::QueueCollisionSwaps()
+{
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+	const float MaxSpeedSq = FMath::Square(Settings->CollisionLODMaxSpeed);
+	constexpr uint8 MinTier = static_cast<uint8>(EPropPhysicsLOD::Reduced);
+	constexpr uint8 MaxTier = static_cast<uint8>(EPropPhysicsLOD::Frozen);
+
+	PendingCollisionSwaps.Reset();
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		// Props about to change tier wait for it, Dormant brings the authored collision back anyway
+		const uint8 Tier = LODTiers[Index];
+		if (DesiredLODTiers[Index] != Tier) continue;
+
+		const bool bWantSimple = Settings->bEnableCollisionLOD && Tier >= MinTier && Tier <= MaxTier;
+		if (bWantSimple == ((StateFlags[Index] & PSF_SimpleCollision) != 0)) continue;
+
+		const UPhysicsPropComponent* Prop = Props[Index];
+		if (!Prop || !Prop->ManagedMesh || Prop->WeldGroup != INDEX_NONE || Prop->bIsGrabbed) continue;
+
+		// Meshes whose collision is already a single primitive keep it
+		if (bWantSimple && !GetSimpleCollisionSetup(Prop->ManagedMesh->GetStaticMesh())) continue;
+
+		// A new shape under a fast body could make it pop through its contacts
+		if ((StateFlags[Index] & PSF_Awake) != 0 && Prop->ManagedMesh->GetPhysicsLinearVelocity().SizeSquared() > MaxSpeedSq) continue;
+
+		PendingCollisionSwaps.Add(Props[Index]);
+	}
+}
+
+void UPhysicsPropSubsystem::HibernateProp(UPhysicsPropComponent* Prop)
+{
+	if (!Prop || Prop->bHibernated || Prop->PhysicsLOD != EPropPhysicsLOD::Dormant || !Prop->ManagedMesh) return;
+
+	UStaticMesh* Mesh = Prop->ManagedMesh->GetStaticMesh();
+	if (!Mesh) return;
+
+	FPropProxyBatch& Batch = GetOrCreateProxyBatch(Mesh, Prop);
+	Prop->ProxyInstance = Batch.Instances->AddInstance(Prop->ManagedMesh->GetComponentTransform(), /*bWorldSpace*/ true);
+	Batch.Props.Add(Prop);
+
+	// The instance draws the prop from now on
+	Prop->bHibernated = true;
+	Prop->GetOwner()->SetActorHiddenInGame(true);
+}
+
+void UPhysicsPropSubsystem::RehydrateProp(UPhysicsPropComponent* Prop)
+{
+	if (!Prop || !Prop->bHibernated) return;
+
+	Prop->bHibernated = false;
+	Prop->GetOwner()->SetActorHiddenInGame(false);
+
+	const int32 InstanceIndex = Prop->ProxyInstance;
+	Prop->ProxyInstance = INDEX_NONE;
+
+	UStaticMesh* Mesh = Prop->ManagedMesh ? Prop->ManagedMesh->GetStaticMesh() : nullptr;
+	FPropProxyBatch* Batch = ProxyBatches.Find(Mesh);
+	if (!Batch || !Batch->Props.IsValidIndex(InstanceIndex) || Batch->Props[InstanceIndex] != Prop) return;
+
+	// The last instance moves into the hole, same for its prop
+	Batch->Props.RemoveAtSwap(InstanceIndex, 1, EAllowShrinking::No);
+	if (Batch->Instances)
+	{
+		Batch->Instances->RemoveInstance(InstanceIndex);
+	}
+	if (Batch->Props.IsValidIndex(InstanceIndex) && Batch->Props[InstanceIndex])
+	{
+		Batch->Props[InstanceIndex]->ProxyInstance = InstanceIndex;
+	}
+}
+
+void UPhysicsPropSubsystem::RehydratePropsInRadius(FVector Origin, float Radius)
+{
+	const float RadiusSq = FMath::Square(Radius);
+
+	TArray<UPhysicsPropComponent*, TInlineAllocator<32>> Found;
+	Grid.ForEachInRadius(Origin, Radius, [&](int32 Index)
+	{
+		if (Props[Index] && Props[Index]->bHibernated && FVector::DistSquared(FVector(PosX[Index], PosY[Index], PosZ[Index]), Origin) <= RadiusSq)
+		{
+			Found.Add(Props[Index]);
+		}
+	});
+
+	for (UPhysicsPropComponent* Prop : Found)
+	{
+		RehydrateProp(Prop);
+		Prop->PromoteToFullLOD();
+	}
+}
+
+AActor* UPhysicsPropSubsystem::RehydratePropFromHit(const FHitResult& Hit)
+{
+	const UInstancedStaticMeshComponent* HitInstances = Cast<UInstancedStaticMeshComponent>(Hit.GetComponent());
+	if (!HitInstances || HitInstances->GetOwner() != ProxyActor || !ProxyActor) return nullptr;
+
+	FPropProxyBatch* Batch = ProxyBatches.Find(HitInstances->GetStaticMesh());
+	if (!Batch || !Batch->Props.IsValidIndex(Hit.Item)) return nullptr;
+
+	UPhysicsPropComponent* Prop = Batch->Props[Hit.Item];
+	if (!Prop) return nullptr;
+
+	RehydrateProp(Prop);
+	Prop->PromoteToFullLOD();
+	return Prop->GetOwner();
+}
+
+AActor* UPhysicsPropSubsystem::AcquireProp(TSubclassOf<AActor> PropClass, FTransform Transform, UStaticMesh* Mesh)
+{
+	if (!PropClass) return nullptr;
+
+	AActor* Actor = nullptr;
+	if (FPropPool* Pool = Pools.Find(PropClass))
+	{
+		Pool->Available.RemoveAllSwap([](const AActor* Candidate) { return !IsValid(Candidate); });
+
+		// Prefer a prop already using the mesh, swapping meshes rebuilds the body
+		int32 PoolIndex = Pool->Available.Num() - 1;
+		if (Mesh)
+		{
+			for (int32 Index = 0; Index < Pool->Available.Num(); ++Index)
+			{
+				const UPhysicsPropComponent* Candidate = Pool->Available[Index]->FindComponentByClass<UPhysicsPropComponent>();
+				if (Candidate && Candidate->ManagedMesh && Candidate->ManagedMesh->GetStaticMesh() == Mesh)
+				{
+					PoolIndex = Index;
+					break;
+				}
+			}
+		}
+
+		if (Pool->Available.IsValidIndex(PoolIndex))
+		{
+			Actor = Pool->Available[PoolIndex];
+			Pool->Available.RemoveAtSwap(PoolIndex, 1, EAllowShrinking::No);
+		}
+	}
+
+	// Empty pool: pay for a spawn once, the prop physicalizes itself in BeginPlay
+	if (!Actor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Actor = GetWorld()->SpawnActor<AActor>(PropClass, Transform, SpawnParams);
+		if (!Actor) return nullptr;
+	}
+
+	UPhysicsPropComponent* Prop = Actor->FindComponentByClass<UPhysicsPropComponent>();
+	if (!Prop || !Prop->ManagedMesh) return Actor;
+
+	if (Mesh && Prop->ManagedMesh->GetStaticMesh() != Mesh)
+	{
+		Prop->ManagedMesh->SetStaticMesh(Mesh);
+
+		// Impacts, VFX and sound banks follow the new mesh. Pooled props have no body yet, ReactivateFromPool does it.
+		if (!Prop->bPooled)
+		{
+			Prop->CachePropSurface();
+			if (Prop->PropIndex != INDEX_NONE)
+			{
+				SetPropLocation(Prop->PropIndex, Prop->ManagedMesh->GetComponentLocation());
+			}
+		}
+	}
+
+	if (Prop->bPooled)
+	{
+		Prop->ReactivateFromPool(Transform);
+		RegisterProp(Prop);
+	}
+	return Actor;
+}
+
+void UPhysicsPropSubsystem::ReleaseProp(AActor* PropActor)
+{
+	UPhysicsPropComponent* Prop = PropActor ? PropActor->FindComponentByClass<UPhysicsPropComponent>() : nullptr;
+	if (!Prop || !Prop->ManagedMesh || Prop->bPooled) return;
+
+	FPropPool& Pool = Pools.FindOrAdd(PropActor->GetClass());
+	if (Pool.Available.Num() >= GetDefault<UPhysicsPropSettings>()->MaxPooledPropsPerClass)
+	{
+		PropActor->Destroy();
+		return;
+	}
+
+	// Out of the buffers first: the passes must not touch it while it is parked
+	UnregisterProp(Prop);
+	Prop->DeactivateForPool();
+	Pool.Available.Add(PropActor);
+}
+
+void UPhysicsPropSubsystem::PrewarmPool(TSubclassOf<AActor> PropClass, int32 Count)
+{
+	if (!PropClass) return;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		AActor* Actor = GetWorld()->SpawnActor<AActor>(PropClass, FTransform::Identity, SpawnParams);
+		if (!Actor) return;
+
+		ReleaseProp(Actor);
+
+		// Not a physics prop, or the pool is full
+		const UPhysicsPropComponent* Prop = Actor->FindComponentByClass<UPhysicsPropComponent>();
+		if (!Prop || !Prop->bPooled)
+		{
+			if (IsValid(Actor))
+			{
+				Actor->Destroy();
+			}
+			return;
+		}
+	}
+}
+
+void UPhysicsPropSubsystem::AddKillVolume(FBox Volume)
+{
+	if (Volume.IsValid)
+	{
+		KillVolumes.Add(Volume);
+	}
+}
+
+void UPhysicsPropSubsystem::ClearKillVolumes()
+{
+	KillVolumes.Reset();
+}
+
+int32 UPhysicsPropSubsystem::ApplyExplosion(FVector Origin, float Radius, float Damage, TSubclassOf<UDamageType> DamageTypeClass, ERadialImpulseFalloff Falloff)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_ApplyExplosion);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::ApplyExplosion);
+	PHYSICSPROP_TIMING_SCOPE(ApplyExplosion);
+
+	if (Radius <= 0.0f || Props.Num() == 0) return 0;
+
+	// Resolve the damage type once for the whole blast
+	const FPropDamageResponse& Response = GetDamageResponse(DamageTypeClass ? DamageTypeClass->GetDefaultObject<UDamageType>() : nullptr);
+	const float Strength = Damage * Response.RadialDamageMultiplier;
+	const bool bShouldWake = Response.bShouldWake;
+
+	// Awake props may have moved a lot since the last LOD pass, their direction and falloff need where they are now
+	RefreshAwakePositions();
+
+	// 1. Single query of the prop grid, offsets to the origin go into packed buffers
+	TArray<int32> Indices;
+	TArray<float> ImpulseX, ImpulseY, ImpulseZ, Scales;
+
+	const float RadiusSq = FMath::Square(Radius);
+	Grid.ForEachInRadius(Origin, Radius, [&](int32 Index)
+	{
+		const float Dx = PosX[Index] - Origin.X;
+		const float Dy = PosY[Index] - Origin.Y;
+		const float Dz = PosZ[Index] - Origin.Z;
+		if (Dx * Dx + Dy * Dy + Dz * Dz <= RadiusSq)
+		{
+			Indices.Add(Index);
+			ImpulseX.Add(Dx);
+			ImpulseY.Add(Dy);
+			ImpulseZ.Add(Dz);
+		}
+	});
+
+	const int32 NumInRange = Indices.Num();
+	if (NumInRange == 0) return 0;
+
+	const int32 NumLanes = Align(NumInRange, 4);
+	ImpulseX.SetNumZeroed(NumLanes);
+	ImpulseY.SetNumZeroed(NumLanes);
+	ImpulseZ.SetNumZeroed(NumLanes);
+	Scales.SetNumUninitialized(NumLanes);
+
+	// 2. Falloff impulses, 4 props per iteration. Offsets are turned into impulses in place.
+	const VectorRegister4Float VStrength = VectorSetFloat1(Strength);
+	const VectorRegister4Float VInvRadius = VectorSetFloat1(1.0f / Radius);
+	const VectorRegister4Float VMinLenSq = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+	const bool bLinearFalloff = Falloff == RIF_Linear;
+
+	for (int32 Lane = 0; Lane < NumLanes; Lane += 4)
+	{
+		const VectorRegister4Float Dx = VectorLoad(&ImpulseX[Lane]);
+		const VectorRegister4Float Dy = VectorLoad(&ImpulseY[Lane]);
+		const VectorRegister4Float Dz = VectorLoad(&ImpulseZ[Lane]);
+
+		const VectorRegister4Float LenSq = VectorMax(VectorMultiplyAdd(Dz, Dz, VectorMultiplyAdd(Dy, Dy, VectorMultiply(Dx, Dx))), VMinLenSq);
+		const VectorRegister4Float InvLen = VectorReciprocalSqrtAccurate(LenSq);
+		const VectorRegister4Float Dist = VectorMultiply(LenSq, InvLen);
+
+		const VectorRegister4Float Scale = bLinearFalloff
+			? VectorMax(VectorSubtract(VectorOneFloat(), VectorMultiply(Dist, VInvRadius)), VectorZeroFloat())
+			: VectorOneFloat();
+		const VectorRegister4Float Factor = VectorMultiply(VectorMultiply(VStrength, Scale), InvLen);
+
+		VectorStore(VectorMultiply(Dx, Factor), &ImpulseX[Lane]);
+		VectorStore(VectorMultiply(Dy, Factor), &ImpulseY[Lane]);
+		VectorStore(VectorMultiply(Dz, Factor), &ImpulseZ[Lane]);
+		VectorStore(Scale, &Scales[Lane]);
+	}
+
+	// 3. Strongest first, so the wake budget goes to the props closest to the blast
+	TArray<int32> Order;
+	Order.SetNumUninitialized(NumInRange);
+	for (int32 Lane = 0; Lane < NumInRange; ++Lane)
+	{
+		Order[Lane] = Lane;
+	}
+	Order.Sort([&Scales](int32 A, int32 B) { return Scales[A] > Scales[B]; });
+
+	// 4. Apply everything in a single pass
+	const int32 MaxWoken = GetDefault<UPhysicsPropSettings>()->MaxPropsWokenPerExplosion;
+	int32 NumWoken = 0;
+	int32 NumPushed = 0;
+
+	for (const int32 Lane : Order)
+	{
+		UPhysicsPropComponent* Prop = Props[Indices[Lane]];
+		if (!Prop || !Prop->ManagedMesh || Prop->bIsGrabbed) continue;
+
+		FVector Impulse(ImpulseX[Lane], ImpulseY[Lane], ImpulseZ[Lane]);
+		if (Impulse.IsNearlyZero() && Scales[Lane] > 0.0f)
+		{
+			// Right at the origin: push up
+			Impulse = FVector::UpVector * Strength;
+		}
+
+		// Strong enough to split a welded stack: only its props near the blast wake up
+		if (Prop->WeldGroup != INDEX_NONE)
+		{
+			BreakWeldOnImpulse(Prop, Origin, Impulse.Size());
+		}
+
+		const bool bActive = (StateFlags[Indices[Lane]] & PSF_Awake) != 0 && Prop->ManagedMesh->IsSimulatingPhysics();
+		if (!bActive)
+		{
+			// Sleeping props only move if the damage type allows it, and within the budget
+			if (!bShouldWake || NumWoken >= MaxWoken) continue;
+
+			RehydrateProp(Prop);
+			Prop->PromoteToFullLOD();
+			Prop->ManagedMesh->WakeAllRigidBodies();
+			++NumWoken;
+		}
+
+		Prop->ManagedMesh->AddImpulse(Impulse, NAME_None, true);
+		++NumPushed;
+	}
+
+	return NumPushed;
+}
+
+FPropStateRecord UPhysicsPropSubsystem::CapturePropState(int32 Index) const
+{
+	const UPhysicsPropComponent* Prop = Props[Index];
+
+	FPropStateRecord Record;
+	Record.PropId = Prop->StableId;
+	Record.Location = Prop->ManagedMesh->GetComponentLocation();
+	Record.Rotation = Prop->ManagedMesh->GetComponentQuat();
+	Record.bAwake = (StateFlags[Index] & PSF_Awake) != 0;
+	if (Record.bAwake)
+	{
+		Record.LinearVelocity = Prop->ManagedMesh->GetPhysicsLinearVelocity();
+		Record.AngularVelocity = Prop->ManagedMesh->GetPhysicsAngularVelocityInDegrees();
+	}
+	return Record;
+}
+
+void UPhysicsPropSubsystem::ApplyPropState(UPhysicsPropComponent* Prop, const FPropStateRecord& Record)
+{
+	DissolveWeldGroup(Prop);
+	if (Prop->bIsGrabbed)
+	{
+		Prop->Drop();
+	}
+	if (Prop->bHibernated)
+	{
+		RehydrateProp(Prop);
+	}
+	if (Record.bAwake)
+	{
+		Prop->PromoteToFullLOD();
+	}
+
+	Prop->ApplyPropState(Record);
+	SetPropLocation(Prop->PropIndex, Record.Location);
+}
+
+TMap<uint32, UPhysicsPropComponent*> UPhysicsPropSubsystem::MakePropsByStableId() const
+{
+	TMap<uint32, UPhysicsPropComponent*> PropsById;
+	PropsById.Reserve(PropsByStableId.Num());
+	for (const TPair<uint32, UPhysicsPropComponent*>& Pair : PropsByStableId)
+	{
+		if (Pair.Value && !Pair.Value->bPooled)
+		{
+			PropsById.Add(Pair);
+		}
+	}
+	return PropsById;
+}
+
+bool UPhysicsPropSubsystem::HasUniqueStableId(const UPhysicsPropComponent* Prop) const
+{
+	return Prop && !Prop->bPooled && PropsByStableId.FindRef(Prop->StableId) == Prop;
+}
+
+void UPhysicsPropSubsystem::ExcludeStableId(UPhysicsPropComponent* Prop)
+{
+	if (Prop->NetId == 0) return;
+
+	// Already registered: take it out of the aggregated state
+	if (PropsByNetId.FindRef(Prop->NetId) == Prop)
+	{
+		PropsByNetId.Remove(Prop->NetId);
+		NetTargets.Remove(Prop->NetId);
+		if (ReplicationManager)
+		{
+			ReplicationManager->RemoveProp(Prop->NetId);
+		}
+	}
+	Prop->NetId = 0;
+
+	// Replicates as an actor again, clients match it through its own channel
+	if (Prop->GetOwnerRole() == ROLE_Authority)
+	{
+		Prop->GetOwner()->SetReplicates(true);
+	}
+}
+
+void UPhysicsPropSubsystem::SaveAllPropStates(TArray<uint8>& OutData) const
+{
+	int32 NumRecords = 0;
+	for (const UPhysicsPropComponent* Prop : Props)
+	{
+		NumRecords += HasUniqueStableId(Prop) ? 1 : 0;
+	}
+
+	OutData.Reset();
+	FMemoryWriter Writer(OutData);
+	FPropStateSnapshot::SerializeHeader(Writer, NumRecords);
+
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		if (!HasUniqueStableId(Props[Index])) continue;
+
+		FPropStateRecord Record = CapturePropState(Index);
+		FPropStateSnapshot::SerializeRecord(Writer, Record);
+	}
+}
+
+int32 UPhysicsPropSubsystem::RestoreAllPropStates(const TArray<uint8>& Data)
+{
+	FMemoryReader Reader(Data);
+	int32 NumRecords = 0;
+	if (!FPropStateSnapshot::SerializeHeader(Reader, NumRecords)) return 0;
+
+	const TMap<uint32, UPhysicsPropComponent*> PropsById = MakePropsByStableId();
+
+	int32 NumRestored = 0;
+	FPropStateRecord Record;
+	for (int32 RecordIndex = 0; RecordIndex < NumRecords; ++RecordIndex)
+	{
+		FPropStateSnapshot::SerializeRecord(Reader, Record);
+		if (Reader.IsError()) break; // Truncated data
+
+		if (UPhysicsPropComponent* const* Prop = PropsById.Find(Record.PropId))
+		{
+			ApplyPropState(*Prop, Record);
+			++NumRestored;
+		}
+	}
+	return NumRestored;
+}
+
+void UPhysicsPropSubsystem::CapturePropStates(FPropStateSnapshot& OutSnapshot, const ULevel* Level) const
+{
+	OutSnapshot.Records.Reset(Props.Num());
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		const UPhysicsPropComponent* Prop = Props[Index];
+		if (!HasUniqueStableId(Prop) || (Level && Prop->GetOwner()->GetLevel() != Level)) continue;
+
+		OutSnapshot.Records.Add(CapturePropState(Index));
+	}
+}
+
+void UPhysicsPropSubsystem::AddBakedPropStates(const FPropStateSnapshot& Snapshot)
+{
+	const TMap<uint32, UPhysicsPropComponent*> PropsById = MakePropsByStableId();
+
+	for (const FPropStateRecord& Record : Snapshot.Records)
+	{
+		if (UPhysicsPropComponent* const* Prop = PropsById.Find(Record.PropId))
+		{
+			ApplyPropState(*Prop, Record);
+		}
+		else
+		{
+			PendingBakedStates.Add(Record.PropId, Record);
+		}
+	}
+}
+
+int32 UPhysicsPropSubsystem::GetNumAwakeProps() const
+{
+	int32 NumAwake = 0;
+	for (const uint8 Flags : StateFlags)
+	{
+		NumAwake += (Flags & PSF_Awake) != 0 ? 1 : 0;
+	}
+	return NumAwake;
+}
+
+void UPhysicsPropSubsystem::SetPropLocation(int32 Index, const FVector& Location)
+{
+	PosX[Index] = Location.X;
+	PosY[Index] = Location.Y;
+	PosZ[Index] = Location.Z;
+	GridCells[Index] = Grid.Move(Index, GridCells[Index], Location);
+
+	// Bounds follow the mesh (e.g. pooled mesh swaps, scaled props), the LOD pass reads them for the screen size
+	if (const UPhysicsPropComponent* Prop = Props[Index])
+	{
+		if (Prop->ManagedMesh)
+		{
+			BoundsRadius[Index] = Prop->ManagedMesh->Bounds.SphereRadius;
+		}
+	}
+}
+
+void UPhysicsPropSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_SubsystemTick);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::Tick);
+	PHYSICSPROP_TIMING_SCOPE(SubsystemTick);
+
+	Super::Tick(DeltaTime);
+
+	// One combined impulse and one wake per damaged body
+	for (const TWeakObjectPtr<UPhysicsPropComponent>& Prop : PendingDamageFlushes)
+	{
+		if (Prop.IsValid())
+		{
+			Prop->FlushDamageImpulses();
+		}
+	}
+	PendingDamageFlushes.Reset();
+
+	// Hits of this frame have all been queued by now
+	ImpactAudio.Flush(GetWorld());
+	ImpactVFX.Flush(GetWorld());
+
+	if (GetNumPendingRegistrations() > 0)
+	{
+		ProcessPendingRegistrations();
+	}
+
+	// Props that began play with the snapshots are all registered: what's left belongs to deleted or renamed actors
+	if (PendingBakedStates.Num() > 0 && GetNumPendingRegistrations() == 0)
+	{
+		PendingBakedStates.Reset();
+	}
+
+	UpdateStatCounters();
+
+	if (Props.Num() == 0) return;
+
+	if (ReplicationManager)
+	{
+		ReplicateAwakeProps();
+	}
+	if (NetTargets.Num() > 0)
+	{
+		InterpolateNetProps(DeltaTime);
+	}
+
+	// CCD runs at every physics step in the physics thread callback
+	if (PhysicsCallback)
+	{
+		ReadPhysicsCallbackOutputs();
+	}
+	else
+	{
+		RunCCDPass();
+	}
+
+	TimeUntilNextCull -= DeltaTime;
+	if (TimeUntilNextCull <= 0.0f)
+	{
+		const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+		TimeUntilNextCull = Settings->CullInterval;
+		RunLODPass();
+
+		// Clients get welded props through replication
+		if (Settings->bEnableWelding && GetWorld()->GetNetMode() != NM_Client)
+		{
+			RunWeldPass();
+		}
+	}
+
+	ApplyLODTransitions();
+}
+
+void UPhysicsPropSubsystem::RefreshMaxCullDistance()
+{
+	if (!bMaxCullDistanceDirty) return;
+	bMaxCullDistanceDirty = false;
+
+	// Props without cull distance (FLT_MAX) stay Full whatever the query radius
+	float MaxDistSq = 0.0f;
+	for (const float DistSq : CullDistSq)
+	{
+		if (DistSq != FLT_MAX)
+		{
+			MaxDistSq = FMath::Max(MaxDistSq, DistSq);
+		}
+	}
+	MaxCullDistance = FMath::Sqrt(MaxDistSq);
+}
+
+void UPhysicsPropSubsystem::UpdateStatCounters() const
+{
+#if STATS || CSV_PROFILER
+	int32 NumAwake = 0;
+	int32 NumCulled = 0;
+	int32 NumSimpleCollision = 0;
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		NumAwake += (StateFlags[Index] & PSF_Awake) != 0 ? 1 : 0;
+		NumSimpleCollision += (StateFlags[Index] & PSF_SimpleCollision) != 0 ? 1 : 0;
+		NumCulled += LODTiers[Index] >= static_cast<uint8>(EPropPhysicsLOD::Frozen) ? 1 : 0;
+	}
+	const int32 NumAsleep = Props.Num() - NumAwake;
+
+	SET_DWORD_STAT(STAT_PhysicsProps_NumAwake, NumAwake);
+	SET_DWORD_STAT(STAT_PhysicsProps_NumAsleep, NumAsleep);
+	SET_DWORD_STAT(STAT_PhysicsProps_NumCulled, NumCulled);
+	SET_DWORD_STAT(STAT_PhysicsProps_NumPendingRegistrations, GetNumPendingRegistrations());
+	SET_DWORD_STAT(STAT_PhysicsProps_NumSoundBanks, ImpactSoundBanks.GetNumBanks());
+	SET_DWORD_STAT(STAT_PhysicsProps_NumWelded, NumWeldedProps);
+	SET_DWORD_STAT(STAT_PhysicsProps_NumSimpleCollision, NumSimpleCollision);
+
+	CSV_CUSTOM_STAT(PhysicsProps, NumAwake, NumAwake, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(PhysicsProps, NumAsleep, NumAsleep, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(PhysicsProps, NumCulled, NumCulled, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(PhysicsProps, NumPendingRegistrations, GetNumPendingRegistrations(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(PhysicsProps, NumSoundBanks, ImpactSoundBanks.GetNumBanks(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(PhysicsProps, NumWelded, NumWeldedProps, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(PhysicsProps, NumSimpleCollision, NumSimpleCollision, ECsvCustomStatOp::Set);
+#endif
+}
+
+void UPhysicsPropSubsystem::ReplicateAwakeProps()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_NetReplication);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::ReplicateAwakeProps);
+	PHYSICSPROP_TIMING_SCOPE(NetReplication);
+
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		if ((StateFlags[Index] & PSF_Awake) == 0) continue;
+
+		UPhysicsPropComponent* Prop = Props[Index];
+		if (!Prop || !Prop->ManagedMesh || Prop->NetId == 0 || CurrentTime < Prop->NextNetStateTime) continue;
+
+		// Farther props are sent less often
+		const bool bReduced = LODTiers[Index] == static_cast<uint8>(EPropPhysicsLOD::Reduced);
+		Prop->NextNetStateTime = CurrentTime + 1.0f / (bReduced ? Settings->NetUpdateFrequencyReduced : Settings->NetUpdateFrequencyFull);
+
+		const UStaticMeshComponent* Mesh = Prop->ManagedMesh;
+		FPropNetState State;
+		State.Capture(Mesh->GetComponentTransform(), Mesh->GetPhysicsLinearVelocity(), Mesh->GetPhysicsAngularVelocityInDegrees(), true);
+		ReplicationManager->UpdatePropState(Prop->NetId, State, CurrentTime);
+	}
+
+	ReplicationManager->RemoveSettledProps(CurrentTime);
+}
+
+void UPhysicsPropSubsystem::ReceiveNetPropState(uint32 PropId, const FPropNetState& State)
+{
+	UPhysicsPropComponent* Prop = PropsByNetId.FindRef(PropId);
+	if (!Prop) return;
+
+	FPropNetTarget& Target = NetTargets.FindOrAdd(PropId);
+	Target.State = State;
+	Target.Rotation = State.GetRotation();
+	Target.ReceiveTime = GetWorld()->GetTimeSeconds();
+
+	// The prop moves on the server, show it here whatever our local LOD
+	Prop->PromoteToFullLOD();
+}
+
+void UPhysicsPropSubsystem::InterpolateNetProps(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_NetInterpolation);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::InterpolateNetProps);
+	PHYSICSPROP_TIMING_SCOPE(NetInterpolation);
+
+	// Velocity extrapolation is capped, a late packet shouldn't throw props away
+	constexpr float MaxExtrapolationTime = 0.25f;
+
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	const float SnapDistSq = FMath::Square(Settings->NetSnapDistance);
+
+	for (auto It = NetTargets.CreateIterator(); It; ++It)
+	{
+		UPhysicsPropComponent* Prop = PropsByNetId.FindRef(It.Key());
+		if (!Prop || !Prop->ManagedMesh)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		const FPropNetTarget& Target = It.Value();
+		UStaticMeshComponent* Mesh = Prop->ManagedMesh;
+
+		const float Age = FMath::Min(CurrentTime - Target.ReceiveTime, MaxExtrapolationTime);
+		const FVector TargetLocation = Target.State.Location + Target.State.LinearVelocity * Age;
+
+		FVector NewLocation = TargetLocation;
+		FQuat NewRotation = Target.Rotation;
+		if (FVector::DistSquared(Mesh->GetComponentLocation(), TargetLocation) <= SnapDistSq)
+		{
+			NewLocation = FMath::VInterpTo(Mesh->GetComponentLocation(), TargetLocation, DeltaTime, Settings->NetInterpolationSpeed);
+			NewRotation = FMath::QInterpTo(Mesh->GetComponentQuat(), Target.Rotation, DeltaTime, Settings->NetInterpolationSpeed);
+		}
+
+		Mesh->SetWorldLocationAndRotation(NewLocation, NewRotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+		if (Target.State.bAwake)
+		{
+			Mesh->SetPhysicsLinearVelocity(Target.State.LinearVelocity);
+			Mesh->SetPhysicsAngularVelocityInDegrees(Target.State.AngularVelocity);
+		}
+		else if (FVector::DistSquared(NewLocation, TargetLocation) < 1.0f)
+		{
+			// Settled on the server and caught up here
+			Mesh->SetWorldLocationAndRotation(TargetLocation, Target.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+			Mesh->PutRigidBodyToSleep();
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UPhysicsPropSubsystem::ReadPhysicsCallbackOutputs()
+{
+	int32 NumToggles = 0;
+	while (Chaos::TSimCallbackOutputHandle<FPropSimOutput> Output = PhysicsCallback->PopOutputData_External())
+	{
+		NumToggles += Output->NumCCDToggles;
+	}
+
+	INC_DWORD_STAT_BY(STAT_PhysicsProps_CCDToggles, NumToggles);
+	CSV_CUSTOM_STAT(PhysicsProps, CCDToggles, NumToggles, ECsvCustomStatOp::Set);
+}
+
+void UPhysicsPropSubsystem::RunCCDPass()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_CCDPass);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::RunCCDPass);
+	PHYSICSPROP_TIMING_SCOPE(CCDPass);
+
+	CCDIndices.Reset();
+	CCDVelX.Reset();
+	CCDVelY.Reset();
+	CCDVelZ.Reset();
+	CCDThresholds.Reset();
+
+	// Gather the velocity of awake props into contiguous buffers
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		if ((StateFlags[Index] & PSF_Awake) == 0 || CCDThresholdSq[Index] == FLT_MAX) continue;
+
+		const UPhysicsPropComponent* Prop = Props[Index];
+		if (!Prop || !Prop->ManagedMesh) continue;
+
+		const FVector Velocity = Prop->ManagedMesh->GetComponentVelocity();
+		CCDIndices.Add(Index);
+		CCDVelX.Add(Velocity.X);
+		CCDVelY.Add(Velocity.Y);
+		CCDVelZ.Add(Velocity.Z);
+		CCDThresholds.Add(CCDThresholdSq[Index]);
+	}
+
+	const int32 NumAwake = CCDIndices.Num();
+	if (NumAwake == 0) return;
+
+	// Pad to the SIMD width, padding lanes never pass the threshold
+	const int32 NumLanes = Align(NumAwake, 4);
+	CCDVelX.SetNumZeroed(NumLanes);
+	CCDVelY.SetNumZeroed(NumLanes);
+	CCDVelZ.SetNumZeroed(NumLanes);
+	CCDThresholds.Reserve(NumLanes);
+	while (CCDThresholds.Num() < NumLanes)
+	{
+		CCDThresholds.Add(FLT_MAX);
+	}
+	CCDMasks.SetNumUninitialized(NumLanes / 4);
+
+	// Dynamic CCD management to avoid tunneling at high speeds, 4 props per iteration
+	for (int32 Lane = 0; Lane < NumLanes; Lane += 4)
+	{
+		const VectorRegister4Float Vx = VectorLoad(&CCDVelX[Lane]);
+		const VectorRegister4Float Vy = VectorLoad(&CCDVelY[Lane]);
+		const VectorRegister4Float Vz = VectorLoad(&CCDVelZ[Lane]);
+		const VectorRegister4Float SpeedSq = VectorMultiplyAdd(Vz, Vz, VectorMultiplyAdd(Vy, Vy, VectorMultiply(Vx, Vx)));
+
+		CCDMasks[Lane / 4] = static_cast<uint8>(VectorMaskBits(VectorCompareGT(SpeedSq, VectorLoad(&CCDThresholds[Lane]))));
+	}
+
+	// Only call SetUseCCD if state changes to avoid overhead
+	int32 NumToggles = 0;
+	for (int32 Lane = 0; Lane < NumAwake; ++Lane)
+	{
+		const int32 Index = CCDIndices[Lane];
+		const bool bShouldUseCCD = ((CCDMasks[Lane / 4] >> (Lane % 4)) & 1) != 0;
+		const bool bUsesCCD = (StateFlags[Index] & PSF_CCD) != 0;
+
+		if (bShouldUseCCD != bUsesCCD)
+		{
+			StateFlags[Index] = bShouldUseCCD ? (StateFlags[Index] | PSF_CCD) : (StateFlags[Index] & ~PSF_CCD);
+			Props[Index]->ManagedMesh->SetUseCCD(bShouldUseCCD);
+			++NumToggles;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_PhysicsProps_CCDToggles, NumToggles);
+	CSV_CUSTOM_STAT(PhysicsProps, CCDToggles, NumToggles, ECsvCustomStatOp::Set);
+}
+
+void UPhysicsPropSubsystem::GatherPositions()
+{
+	const float KillZ = GetDefault<UPhysicsPropSettings>()->KillZ;
+	AwakePositionsFrame = GFrameCounter;
+
+	// Sleeping props don't move, only refresh the ones that are awake
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		if ((StateFlags[Index] & PSF_Awake) == 0) continue;
+
+		const UPhysicsPropComponent* Prop = Props[Index];
+		if (!Prop || !Prop->ManagedMesh) continue;
+
+		const FVector Location = Prop->ManagedMesh->GetComponentLocation();
+		SetPropLocation(Index, Location);
+
+		// Basic safety: If object falls too low (under map), remove it to save perfs.
+		// Props that are never culled never were removed either, only kill volumes apply to them.
+		bool bOutOfWorld = CullDistSq[Index] != FLT_MAX && Location.Z < KillZ;
+		for (int32 VolumeIndex = 0; VolumeIndex < KillVolumes.Num() && !bOutOfWorld; ++VolumeIndex)
+		{
+			bOutOfWorld = KillVolumes[VolumeIndex].IsInsideOrOn(Location);
+		}
+
+		if (bOutOfWorld)
+		{
+			OutOfWorldActors.Add(Prop->GetOwner());
+		}
+	}
+}
+
+void UPhysicsPropSubsystem::RefreshAwakePositions()
+{
+	if (AwakePositionsFrame == GFrameCounter) return;
+	AwakePositionsFrame = GFrameCounter;
+
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		if ((StateFlags[Index] & PSF_Awake) == 0) continue;
+
+		const UPhysicsPropComponent* Prop = Props[Index];
+		if (Prop && Prop->ManagedMesh)
+		{
+			SetPropLocation(Index, Prop->ManagedMesh->GetComponentLocation());
+		}
+	}
+}
+
+void UPhysicsPropSubsystem::GatherObservers()
+{
+	Observers.Reset();
+	ObserverViews.Reset();
+
+	// Every local and remote player: handles split-screen, listen and dedicated servers
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PC = It->Get())
+		{
+			FVector ViewLoc;
+			FRotator ViewRot;
+			PC->GetPlayerViewPoint(ViewLoc, ViewRot);
+			Observers.Add(ViewLoc);
+
+			// Horizontal FOV: the cone is a bit larger than the view vertically, which only keeps more props visible
+			const float HalfFOV = FMath::DegreesToRadians(FMath::Clamp(PC->PlayerCameraManager ? PC->PlayerCameraManager->GetFOVAngle() : 90.0f, 1.0f, 170.0f) * 0.5f);
+			FPropObserverView& View = ObserverViews.AddDefaulted_GetRef();
+			View.Forward = ViewRot.Vector();
+			View.CosHalfFOV = FMath::Cos(HalfFOV);
+			View.TanHalfFOV = FMath::Tan(HalfFOV);
+			View.bHasView = true;
+		}
+	}
+
+	for (int32 Index = InterestSources.Num() - 1; Index >= 0; --Index)
+	{
+		if (const AActor* Source = InterestSources[Index].Get())
+		{
+			Observers.Add(Source->GetActorLocation());
+			ObserverViews.AddDefaulted();
+		}
+		else
+		{
+			InterestSources.RemoveAtSwap(Index);
+		}
+	}
+}
+
+void UPhysicsPropSubsystem::RunLODPass()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_LODPass);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::RunLODPass);
+	PHYSICSPROP_TIMING_SCOPE(LODPass);
+
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	GatherPositions();
+	GatherObservers();
+
+	const int32 NumProps = Props.Num();
+
+	// Tier boundaries as squared multiples of each prop's PhysicsCullDistance
+	const float EnterRatioSq[4] = {
+		0.0f,
+		FMath::Square(Settings->LODReducedDistanceRatio),
+		FMath::Square(Settings->LODFrozenDistanceRatio),
+		FMath::Square(Settings->LODDormantDistanceRatio) };
+	const float ExitScaleSq = FMath::Square(1.0f - FMath::Clamp(Settings->LODHysteresis, 0.0f, 0.9f));
+
+	// One task per observer, each one only visits the grid cells around it.
+	// Anything beyond the Dormant boundary of the farthest-reaching prop is dormant anyway.
+	struct FNearProp
+	{
+		int32 Index;
+		float DistSq;
+
+		/** Fraction of the screen covered by the bounds, -1 if out of the view cone. */
+		float ScreenSize;
+	};
+	TArray<TArray<FNearProp>> NearPerObserver;
+	NearPerObserver.SetNum(Observers.Num());
+
+	const float* RESTRICT X = PosX.GetData();
+	const float* RESTRICT Y = PosY.GetData();
+	const float* RESTRICT Z = PosZ.GetData();
+	const float* RESTRICT Radii = BoundsRadius.GetData();
+	const float* RESTRICT MaxDistSq = CullDistSq.GetData();
+	RefreshMaxCullDistance();
+	const float QueryRadius = MaxCullDistance * FMath::Max(Settings->LODDormantDistanceRatio, Settings->LODFrozenDistanceRatio);
+	const float QueryRatioSq = EnterRatioSq[3];
+	const bool bVisibilityAware = Settings->bVisibilityAwareLOD;
+
+	ParallelFor(Observers.Num(), [&](int32 ObserverIndex)
+	{
+		const FVector& Observer = Observers[ObserverIndex];
+		const FPropObserverView& View = ObserverViews[ObserverIndex];
+		const bool bTestView = bVisibilityAware && View.bHasView;
+		const float Ox = Observer.X;
+		const float Oy = Observer.Y;
+		const float Oz = Observer.Z;
+		const float Fx = View.Forward.X;
+		const float Fy = View.Forward.Y;
+		const float Fz = View.Forward.Z;
+		TArray<FNearProp>& Near = NearPerObserver[ObserverIndex];
+
+		Grid.ForEachCellInRadius(Observer, QueryRadius, [&](const TArray<int32>& CellIds)
+		{
+			for (const int32 Index : CellIds)
+			{
+				const float Dx = X[Index] - Ox;
+				const float Dy = Y[Index] - Oy;
+				const float Dz = Z[Index] - Oz;
+				const float DistSq = Dx * Dx + Dy * Dy + Dz * Dz;
+				if (DistSq > MaxDistSq[Index] * QueryRatioSq) continue;
+
+				// Sphere against view cone, conservative: a prop partly in view is in view
+				float ScreenSize = 0.0f;
+				if (bTestView)
+				{
+					const float Dist = FMath::Sqrt(DistSq);
+					const bool bInView = Dx * Fx + Dy * Fy + Dz * Fz + Radii[Index] >= View.CosHalfFOV * Dist;
+					ScreenSize = bInView ? Radii[Index] / FMath::Max(Dist * View.TanHalfFOV, 1.0f) : -1.0f;
+				}
+				Near.Add({ Index, DistSq, ScreenSize });
+			}
+		});
+	});
+
+	LODScreenSizes.SetNumUninitialized(NumProps);
+	for (int32 Index = 0; Index < NumProps; ++Index)
+	{
+		NearestDistSq[Index] = FLT_MAX;
+		LODScreenSizes[Index] = -1.0f;
+	}
+	for (const TArray<FNearProp>& Near : NearPerObserver)
+	{
+		for (const FNearProp& Entry : Near)
+		{
+			NearestDistSq[Entry.Index] = FMath::Min(NearestDistSq[Entry.Index], Entry.DistSq);
+			LODScreenSizes[Entry.Index] = FMath::Max(LODScreenSizes[Entry.Index], Entry.ScreenSize);
+		}
+	}
+
+	UpdateImpactSoundBanks();
+
+	// Distance used to pick the tier: unseen props count as farther, large props on screen as right there
+	const float* RESTRICT DistSqs = NearestDistSq.GetData();
+	if (bVisibilityAware)
+	{
+		const float OffscreenScaleSq = FMath::Square(FMath::Max(Settings->LODOffscreenDistanceScale, 1.0f));
+		const float KeepFullScreenSize = Settings->LODKeepFullScreenSize;
+		const bool bCheckRecentRender = Settings->LODRecentRenderTime > 0.0f && GetWorld()->GetNetMode() != NM_DedicatedServer;
+
+		LODDistSq.SetNumUninitialized(NumProps);
+		for (int32 Index = 0; Index < NumProps; ++Index)
+		{
+			float DistSq = NearestDistSq[Index];
+			const float ScreenSize = LODScreenSizes[Index];
+
+			if (DistSq != FLT_MAX)
+			{
+				// Render time is only read for props out of every view cone
+				const UPhysicsPropComponent* Prop = Props[Index];
+				const bool bSeen = ScreenSize >= 0.0f || (bCheckRecentRender && Prop && Prop->ManagedMesh
+					&& CurrentTime - Prop->ManagedMesh->GetLastRenderTimeOnScreen() <= Settings->LODRecentRenderTime);
+
+				if (!bSeen)
+				{
+					DistSq *= OffscreenScaleSq;
+				}
+				else if (KeepFullScreenSize > 0.0f && ScreenSize >= KeepFullScreenSize)
+				{
+					DistSq = 0.0f;
+				}
+			}
+			LODDistSq[Index] = DistSq;
+		}
+		DistSqs = LODDistSq.GetData();
+	}
+
+	// Pick the tier of every prop. A prop only leaves its tier once it is past the
+	// hysteresis band, so props straddling a boundary don't flip back and forth.
+	const uint8* RESTRICT Current = LODTiers.GetData();
+	uint8* RESTRICT Desired = DesiredLODTiers.GetData();
+	constexpr uint8 MaxTier = static_cast<uint8>(EPropPhysicsLOD::Dormant);
+
+	for (int32 Index = 0; Index < NumProps; ++Index)
+	{
+		const float DistSq = DistSqs[Index];
+		const float CullSq = MaxDistSq[Index];
+
+		uint8 Tier = Current[Index];
+		if (CullSq == FLT_MAX)
+		{
+			Tier = 0;
+		}
+		else
+		{
+			while (Tier > 0 && DistSq < CullSq * EnterRatioSq[Tier] * ExitScaleSq)
+			{
+				--Tier;
+			}
+			while (Tier < MaxTier && DistSq > CullSq * EnterRatioSq[Tier + 1])
+			{
+				++Tier;
+			}
+
+			// Recently promoted props (damage, grab) aren't demoted before their hold time is over
+			if (Tier > Current[Index] && Props[Index] && Props[Index]->FullLODHoldUntilTime > CurrentTime)
+			{
+				Tier = Current[Index];
+			}
+		}
+		Desired[Index] = Tier;
+	}
+
+	// Welded props stay in the closer tiers: a group splits before any of its props gets frozen or dormant
+	if (NumWeldedProps > 0)
+	{
+		for (int32 Index = 0; Index < NumProps; ++Index)
+		{
+			if (Desired[Index] > static_cast<uint8>(EPropPhysicsLOD::Reduced) && Props[Index] && Props[Index]->WeldGroup != INDEX_NONE)
+			{
+				DissolveWeldGroup(Props[Index]);
+			}
+		}
+	}
+
+	// Queue the changes: promotions first, then closest first
+	TArray<int32> Changed;
+	for (int32 Index = 0; Index < NumProps; ++Index)
+	{
+		if (Desired[Index] != Current[Index])
+		{
+			Changed.Add(Index);
+		}
+	}
+	Changed.Sort([this](int32 A, int32 B)
+	{
+		const bool bPromoteA = DesiredLODTiers[A] < LODTiers[A];
+		const bool bPromoteB = DesiredLODTiers[B] < LODTiers[B];
+		if (bPromoteA != bPromoteB)
+		{
+			return bPromoteA;
+		}
+		return NearestDistSq[A] < NearestDistSq[B];
+	});
+
+	PendingLODTransitions.Reset();
+	NextLODTransition = 0;
+	for (const int32 Index : Changed)
+	{
+		PendingLODTransitions.Add(Props[Index]);
+	}
+
+	// Props dormant for long enough get hibernated
+	if (Settings->bEnableHibernation)
+	{
+		PendingHibernations.Reset();
+
+		for (int32 Index = 0; Index < NumProps; ++Index)
+		{
+			const UPhysicsPropComponent* Prop = Props[Index];
+			if (Current[Index] == MaxTier && Desired[Index] == MaxTier && Prop && !Prop->bHibernated
+				&& CurrentTime - Prop->DormantSinceTime >= Settings->HibernationDelay)
+			{
+				PendingHibernations.Add(Props[Index]);
+			}
+		}
+	}
+
+	QueueCollisionSwaps();
+
+	// Recycling or destroying unregisters the props, so it must happen after the buffers have been walked
+	const bool bRecycle = GetDefault<UPhysicsPropSettings>()->bRecycleOutOfWorldProps;
+	for (const TWeakObjectPtr<AActor>& Actor : OutOfWorldActors)
+	{
+		if (!Actor.IsValid()) continue;
+
+		if (bRecycle)
+		{
+			ReleaseProp(Actor.Get());
+		}
+		else
+		{
+			Actor->Destroy();
+		}
+	}
+	OutOfWorldActors.Reset();
+}
+
+void UPhysicsPropSubsystem::RunWeldPass()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_WeldPass);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::RunWeldPass);
+	PHYSICSPROP_TIMING_SCOPE(WeldPass);
+
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	constexpr uint8 MaxWeldTier = static_cast<uint8>(EPropPhysicsLOD::Reduced);
+
+	// 1. Props at rest for long enough, with their bounds grown by the contact tolerance
+	TArray<int32> Slots;
+	Slots.Init(INDEX_NONE, Props.Num());
+	TArray<int32> Candidates;
+	TArray<FBox> Boxes;
+	float MaxRadius = 0.0f;
+
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		if ((StateFlags[Index] & PSF_Awake) != 0 || LODTiers[Index] > MaxWeldTier) continue;
+
+		const UPhysicsPropComponent* Prop = Props[Index];
+		if (!Prop || !Prop->ManagedMesh || Prop->WeldGroup != INDEX_NONE || Prop->bIsGrabbed || Prop->bPooled || Prop->bHibernated) continue;
+		if ((StateFlags[Index] & PSF_SimpleCollision) != 0) continue;
+		if (CurrentTime - Prop->AsleepSinceTime < Settings->WeldDelay || !Prop->ManagedMesh->IsSimulatingPhysics()) continue;
+
+		Slots[Index] = Candidates.Add(Index);
+		Boxes.Add(Prop->ManagedMesh->Bounds.GetBox().ExpandBy(Settings->WeldContactTolerance));
+		MaxRadius = FMath::Max(MaxRadius, (float)Prop->ManagedMesh->Bounds.SphereRadius);
+	}
+
+	if (Candidates.Num() < 2) return;
+
+	// 2. Touching pairs, only looking at the grid cells around each candidate
+	TArray<TArray<int32, TInlineAllocator<8>>> Neighbors;
+	Neighbors.SetNum(Candidates.Num());
+
+	for (int32 Slot = 0; Slot < Candidates.Num(); ++Slot)
+	{
+		const FBox& Box = Boxes[Slot];
+		const float QueryRadius = Box.GetExtent().Size() + MaxRadius * 2.0f;
+		Grid.ForEachInRadius(Box.GetCenter(), QueryRadius, [&](int32 OtherIndex)
+		{
+			const int32 OtherSlot = Slots[OtherIndex];
+			if (OtherSlot > Slot && Box.Intersect(Boxes[OtherSlot]))
+			{
+				Neighbors[Slot].Add(OtherSlot);
+				Neighbors[OtherSlot].Add(Slot);
+			}
+		});
+	}
+
+	// 3. Connected groups, breadth first and capped in size: what's left of a large stack seeds the next groups
+	const int32 MaxGroupSize = FMath::Max(Settings->MaxWeldGroupSize, 2);
+	TBitArray<> Visited(false, Candidates.Num());
+	TArray<int32> Queue;
+	TArray<UPhysicsPropComponent*> Members;
+
+	for (int32 Seed = 0; Seed < Candidates.Num(); ++Seed)
+	{
+		if (Visited[Seed] || Neighbors[Seed].Num() == 0) continue;
+
+		Queue.Reset();
+		Queue.Add(Seed);
+		Visited[Seed] = true;
+
+		for (int32 Head = 0; Head < Queue.Num() && Queue.Num() < MaxGroupSize; ++Head)
+		{
+			for (const int32 Neighbor : Neighbors[Queue[Head]])
+			{
+				if (!Visited[Neighbor] && Queue.Num() < MaxGroupSize)
+				{
+					Visited[Neighbor] = true;
+					Queue.Add(Neighbor);
+				}
+			}
+		}
+
+		if (Queue.Num() < 2) continue;
+
+		Members.Reset();
+		for (const int32 Slot : Queue)
+		{
+			Members.Add(Props[Candidates[Slot]]);
+		}
+		WeldProps(Members);
+	}
+}
+
+void UPhysicsPropSubsystem::WeldProps(const TArray<UPhysicsPropComponent*>& Members)
+{
+	const int32 GroupIndex = WeldGroups.Add(FPropWeldGroup());
+	WeldGroups[GroupIndex].Members = Members;
+	NumWeldedProps += Members.Num();
+
+	// Every other body becomes a shape of the first one, the meshes keep drawing where they are
+	UStaticMeshComponent* RootMesh = Members[0]->ManagedMesh;
+	const FAttachmentTransformRules WeldRules(EAttachmentRule::KeepWorld, true);
+
+	for (int32 MemberIndex = 0; MemberIndex < Members.Num(); ++MemberIndex)
+	{
+		UPhysicsPropComponent* Member = Members[MemberIndex];
+		Member->WeldGroup = GroupIndex;
+		if (MemberIndex > 0)
+		{
+			Member->ManagedMesh->AttachToComponent(RootMesh, WeldRules);
+		}
+	}
+
+	// The stack was at rest, welding must not wake it
+	RootMesh->PutRigidBodyToSleep();
+}
+
+void UPhysicsPropSubsystem::BreakWeldGroup(int32 GroupIndex, const FVector& Location, float WakeRadius)
+{
+	const TArray<UPhysicsPropComponent*> Members = MoveTemp(WeldGroups[GroupIndex].Members);
+	WeldGroups.RemoveAt(GroupIndex);
+	NumWeldedProps -= Members.Num();
+
+	const bool bGroupAwake = Members[0]->ManagedMesh && Members[0]->ManagedMesh->RigidBodyIsAwake();
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	for (int32 MemberIndex = 0; MemberIndex < Members.Num(); ++MemberIndex)
+	{
+		UPhysicsPropComponent* Member = Members[MemberIndex];
+		Member->WeldGroup = INDEX_NONE;
+		Member->AsleepSinceTime = CurrentTime;
+
+		if (MemberIndex > 0 && Member->ManagedMesh)
+		{
+			Member->ManagedMesh->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+
+			// Tier changes of welded props were only recorded, the compound had the tier of the first prop
+			Member->ApplyTierBodySettings();
+		}
+	}
+
+	// Every prop has its own body again, only the ones close to the impact start moving
+	const float WakeRadiusSq = FMath::Square(WakeRadius);
+	for (UPhysicsPropComponent* Member : Members)
+	{
+		if (!Member->ManagedMesh) continue;
+
+		if (bGroupAwake || (WakeRadius > 0.0f && FVector::DistSquared(Member->ManagedMesh->GetComponentLocation(), Location) <= WakeRadiusSq))
+		{
+			Member->ManagedMesh->WakeAllRigidBodies();
+		}
+		else
+		{
+			Member->ManagedMesh->PutRigidBodyToSleep();
+		}
+	}
+}
+
+bool UPhysicsPropSubsystem::BreakWeldOnImpulse(UPhysicsPropComponent* Prop, const FVector& Location, float VelocityChange)
+{
+	if (!Prop || !WeldGroups.IsValidIndex(Prop->WeldGroup)) return false;
+
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+	if (VelocityChange < Settings->WeldBreakVelocityChange) return false;
+
+	BreakWeldGroup(Prop->WeldGroup, Location, Settings->WeldBreakWakeRadius);
+	return true;
+}
+
+UPhysicsPropComponent* UPhysicsPropSubsystem::GetWeldRoot(UPhysicsPropComponent* Prop) const
+{
+	return Prop && WeldGroups.IsValidIndex(Prop->WeldGroup) ? WeldGroups[Prop->WeldGroup].Members[0] : Prop;
+}
+
+void UPhysicsPropSubsystem::DissolveWeldGroup(UPhysicsPropComponent* Prop)
+{
+	if (!Prop || !WeldGroups.IsValidIndex(Prop->WeldGroup)) return;
+
+	BreakWeldGroup(Prop->WeldGroup, FVector::ZeroVector, 0.0f);
+}
+
+void UPhysicsPropSubsystem::UpdateImpactSoundBanks()
+{
+	// Nobody listens on a dedicated server
+	if (GetWorld()->GetNetMode() == NM_DedicatedServer) return;
+
+	const float RangeSq = FMath::Square(GetDefault<UPhysicsPropSettings>()->ImpactSoundBankRange);
+	for (int32 Index = 0; Index < Props.Num(); ++Index)
+	{
+		UPhysicsPropComponent* Prop = Props[Index];
+		if (Prop && Prop->ImpactTable && NearestDistSq[Index] <= RangeSq)
+		{
+			ImpactSoundBanks.RequireBank(Prop->ImpactTable, Prop->PropSurface);
+		}
+	}
+
+	ImpactSoundBanks.Update(GetWorld()->GetTimeSeconds());
+}
+
+void UPhysicsPropSubsystem::ApplyLODTransitions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsProps_LODTransitions);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPhysicsPropSubsystem::ApplyLODTransitions);
+	PHYSICSPROP_TIMING_SCOPE(LODTransitions);
+
+	const int32 Budget = GetDefault<UPhysicsPropSettings>()->MaxLODTransitionsPerFrame;
+
+	int32 NumApplied = 0;
+	while (NextLODTransition < PendingLODTransitions.Num() && NumApplied < Budget)
+	{
+		UPhysicsPropComponent* Prop = PendingLODTransitions[NextLODTransition++].Get();
+		if (!Prop || !Props.IsValidIndex(Prop->PropIndex)) continue;
+
+		const int32 Index = Prop->PropIndex;
+		const EPropPhysicsLOD NewLOD = static_cast<EPropPhysicsLOD>(DesiredLODTiers[Index]);
+		if (static_cast<uint8>(NewLOD) == LODTiers[Index]) continue;
+
+		if (Prop->ApplyPhysicsLOD(NewLOD))
+		{
+			LODTiers[Index] = static_cast<uint8>(NewLOD);
+
+			// Frozen and dormant props don't simulate, they won't report going to sleep
+			if (NewLOD >= EPropPhysicsLOD::Frozen)
+			{
+				SetPropAwake(Prop, false);
+			}
+
+			// Dormant props get their authored collision back
+			if (NewLOD == EPropPhysicsLOD::Dormant)
+			{
+				StateFlags[Index] &= ~PSF_SimpleCollision;
+			}
+		}
+		++NumApplied;
+	}
+
+	// Hibernations use what is left of the budget
+	while (PendingHibernations.Num() > 0 && NumApplied < Budget)
+	{
+		HibernateProp(PendingHibernations.Pop(EAllowShrinking::No).Get());
+		++NumApplied;
+	}
+
+	// Then collision swaps, which rebuild the body
+	while (PendingCollisionSwaps.Num() > 0 && NumApplied < Budget)
+	{
+		UPhysicsPropComponent* Prop = PendingCollisionSwaps.Pop(EAllowShrinking::No).Get();
+		if (!Prop || !Props.IsValidIndex(Prop->PropIndex)) continue;
+
+		const int32 Index = Prop->PropIndex;
+		const bool bSimple = (StateFlags[Index] & PSF_SimpleCollision) == 0;
+		UBodySetup* SimpleSetup = bSimple ? GetSimpleCollisionSetup(Prop->ManagedMesh->GetStaticMesh()) : nullptr;
+		if (bSimple && !SimpleSetup) continue;
+
+		if (Prop->ApplyCollisionLOD(SimpleSetup))
+		{
+			StateFlags[Index] ^= PSF_SimpleCollision;
+
+			// New body, new particle for the physics thread callback
+			if ((StateFlags[Index] & PSF_Awake) != 0)
+			{
+				SetPropAwake(Prop, true);
+			}
+		}
+		++NumApplied;
+	}
+}
@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropImpactAudioScheduler.h"
+#include "PhysicsPropSettings.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Sound/SoundBase.h"
+#include "PhysicsPropStats.h"
+
+void FPropImpactAudioScheduler::QueueImpact(USoundBase* Sound, const FVector& Location, float Volume)
+{
+	if (!Sound) return;
+
+	const float RadiusSq = FMath::Square(GetDefault<UPhysicsPropSettings>()->ImpactCoalesceRadius);
+
+	// Merge with a hit of the same sound already queued nearby this frame
+	for (FPropImpactSoundRequest& Request : PendingRequests)
+	{
+		if (Request.Sound == Sound && FVector::DistSquared(Request.Location, Location) <= RadiusSq)
+		{
+			Request.Volume = FMath::Max(Request.Volume, Volume);
+			++Request.HitCount;
+			return;
+		}
+	}
+
+	FPropImpactSoundRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Sound = Sound;
+	Request.Location = Location;
+	Request.Volume = Volume;
+}
+
+bool FPropImpactAudioScheduler::IsCoveredByRecentImpact(const USoundBase* Sound, const FVector& Location, float CurrentTime, float RadiusSq) const
+{
+	const float CoalesceTime = GetDefault<UPhysicsPropSettings>()->ImpactCoalesceTime;
+
+	for (const FRecentImpact& Recent : RecentImpacts)
+	{
+		if (Recent.Sound == Sound && CurrentTime - Recent.Time < CoalesceTime && FVector::DistSquared(Recent.Location, Location) <= RadiusSq)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FPropImpactAudioScheduler::Flush(UWorld* World)
+{
+	if (PendingRequests.Num() == 0) return;
+
+	// Nobody listens on a dedicated server
+	if (!World || World->GetNetMode() == NM_DedicatedServer)
+	{
+		PendingRequests.Reset();
+		return;
+	}
+
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+	const float CurrentTime = World->GetTimeSeconds();
+	const float RadiusSq = FMath::Square(Settings->ImpactCoalesceRadius);
+
+	// Forget what is out of the coalescing window and of the per-second budget window
+	RecentImpacts.RemoveAllSwap([CurrentTime, Settings](const FRecentImpact& Recent)
+	{
+		return CurrentTime - Recent.Time >= Settings->ImpactCoalesceTime;
+	});
+
+	int32 NumExpired = 0;
+	while (NumExpired < PlayTimes.Num() && CurrentTime - PlayTimes[NumExpired] >= 1.0f)
+	{
+		++NumExpired;
+	}
+	PlayTimes.RemoveAt(0, NumExpired, EAllowShrinking::No);
+
+	// Local listeners (split-screen)
+	TArray<FVector, TInlineAllocator<4>> Listeners;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ListenerLoc, FrontDir, RightDir;
+			PC->GetAudioListenerPosition(ListenerLoc, FrontDir, RightDir);
+			Listeners.Add(ListenerLoc);
+		}
+	}
+
+	// Rank by loudness and distance to the closest listener
+	const float FalloffDistSq = FMath::Square(FMath::Max(Settings->ImpactListenerFalloffDistance, 1.0f));
+	Scores.SetNumUninitialized(PendingRequests.Num());
+
+	for (int32 Index = 0; Index < PendingRequests.Num(); ++Index)
+	{
+		FPropImpactSoundRequest& Request = PendingRequests[Index];
+
+		// Merged hits play as one louder event
+		Request.Volume = FMath::Min(Request.Volume * (1.0f + Settings->ImpactCoalesceVolumeBoost * (Request.HitCount - 1)), Settings->MaxCoalescedVolume);
+
+		float MinDistSq = Listeners.Num() > 0 ? MAX_flt : 0.0f;
+		for (const FVector& Listener : Listeners)
+		{
+			MinDistSq = FMath::Min(MinDistSq, FVector::DistSquared(Listener, Request.Location));
+		}
+
+		// A matching sound was just played there, this hit is part of the same event
+		const bool bCovered = IsCoveredByRecentImpact(Request.Sound, Request.Location, CurrentTime, RadiusSq);
+		Scores[Index] = bCovered ? -1.0f : Request.Volume / (1.0f + MinDistSq / FalloffDistSq);
+	}
+
+	TArray<int32, TInlineAllocator<64>> Order;
+	Order.SetNumUninitialized(PendingRequests.Num());
+	for (int32 Index = 0; Index < Order.Num(); ++Index)
+	{
+		Order[Index] = Index;
+	}
+	Order.Sort([this](int32 A, int32 B) { return Scores[A] > Scores[B]; });
+
+	// Play the best events within the voice budgets
+	const int32 SecondBudget = FMath::Max(Settings->MaxImpactSoundsPerSecond - PlayTimes.Num(), 0);
+	const int32 Budget = FMath::Min(Settings->MaxImpactSoundsPerFrame, SecondBudget);
+	int32 NumPlayedThisFrame = 0;
+	const int32 NumRejectedBefore = NumRejected;
+
+	for (const int32 Index : Order)
+	{
+		const FPropImpactSoundRequest& Request = PendingRequests[Index];
+
+		if (Scores[Index] < 0.0f || NumPlayedThisFrame >= Budget)
+		{
+			NumRejected += Request.HitCount;
+			continue;
+		}
+
+		// Pitch variation to avoid robotic repetition (0.85 - 1.1)
+		const float Pitch = FMath::RandRange(0.85f, 1.1f);
+		UGameplayStatics::PlaySoundAtLocation(World, Request.Sound, Request.Location, Request.Volume, Pitch);
+
+		RecentImpacts.Add({ Request.Sound, Request.Location, CurrentTime });
+		PlayTimes.Add(CurrentTime);
+		++NumPlayedThisFrame;
+		++NumPlayed;
+		NumRejected += Request.HitCount - 1;
+	}
+
+	INC_DWORD_STAT_BY(STAT_PhysicsProps_ImpactSoundsPlayed, NumPlayedThisFrame);
+	INC_DWORD_STAT_BY(STAT_PhysicsProps_ImpactSoundsRejected, NumRejected - NumRejectedBefore);
+	CSV_CUSTOM_STAT(PhysicsProps, ImpactSoundsPlayed, NumPlayedThisFrame, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(PhysicsProps, ImpactSoundsRejected, NumRejected - NumRejectedBefore, ECsvCustomStatOp::Set);
+
+	PendingRequests.Reset();
+}
+
+void FPropImpactAudioScheduler::Reset()
+{
+	PendingRequests.Reset();
+	RecentImpacts.Reset();
+	PlayTimes.Reset();
+	NumRejected = 0;
+	NumPlayed = 0;
+}
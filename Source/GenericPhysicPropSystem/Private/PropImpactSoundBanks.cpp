@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropImpactSoundBanks.h"
+#include "PropPhysicsImpactData.h"
+#include "PhysicsPropSettings.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+
+void FPropImpactSoundBanks::RequireBank(UPropPhysicsImpactData* Table, EPhysicalSurface PropSurface)
+{
+	if (!Table) return;
+
+	FBank& Bank = Banks.FindOrAdd(MakeTuple(TObjectKey<UPropPhysicsImpactData>(Table), (uint8)PropSurface));
+	Bank.Table = Table;
+	Bank.bRequired = true;
+}
+
+void FPropImpactSoundBanks::Update(float CurrentTime)
+{
+	const float ReleaseDelay = GetDefault<UPhysicsPropSettings>()->ImpactSoundBankReleaseDelay;
+
+	for (auto It = Banks.CreateIterator(); It; ++It)
+	{
+		FBank& Bank = It.Value();
+		UPropPhysicsImpactData* Table = Bank.Table.Get();
+
+		if (Table && Bank.bRequired)
+		{
+			Bank.LastRequiredTime = CurrentTime;
+			Bank.bRequired = false;
+
+			if (!Bank.Handle.IsValid())
+			{
+				// Hits on sounds still loading just stay silent
+				Table->ConditionalCompileImpactTable();
+				const TArray<FSoftObjectPath>& Sounds = Table->GetSoundBank((EPhysicalSurface)It.Key().Value);
+				if (Sounds.Num() > 0)
+				{
+					Bank.Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Sounds, FStreamableDelegate());
+				}
+			}
+			continue;
+		}
+
+		if (!Table || CurrentTime - Bank.LastRequiredTime >= ReleaseDelay)
+		{
+			// Sounds go away with the next garbage collection if nothing else holds them
+			if (Bank.Handle.IsValid())
+			{
+				Bank.Handle->ReleaseHandle();
+			}
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FPropImpactSoundBanks::Reset()
+{
+	for (TPair<TPair<TObjectKey<UPropPhysicsImpactData>, uint8>, FBank>& Pair : Banks)
+	{
+		if (Pair.Value.Handle.IsValid())
+		{
+			Pair.Value.Handle->ReleaseHandle();
+		}
+	}
+	Banks.Reset();
+}
@@ -0,0 +1,284 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropImpactVFXSpawner.h"
+#include "PropPhysicsImpactData.h"
+#include "PhysicsPropSettings.h"
+#include "NiagaraComponent.h"
+#include "NiagaraSystem.h"
+#include "Components/DecalComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "Engine/World.h"
+#include "PhysicsPropStats.h"
+
+namespace PropImpactVFX
+{
+	/** Float user parameter of the impact systems receiving the impact strength. */
+	static const FName StrengthParameter(TEXT("ImpactStrength"));
+
+	/** Time (s) a decal takes to fade out at the end of its lifetime. */
+	static constexpr float DecalFadeDuration = 1.0f;
+
+	/** Pooled components aren't attached to anything, they belong to the world settings like fire and forget effects. */
+	static UObject* GetPoolOuter(UWorld* World)
+	{
+		AWorldSettings* WorldSettings = World->GetWorldSettings();
+		return WorldSettings ? static_cast<UObject*>(WorldSettings) : static_cast<UObject*>(World);
+	}
+}
+
+void FPropImpactVFXSpawner::QueueImpact(const FImpactSoundEntry& Entry, const FVector& Location, const FVector& Normal, float Strength)
+{
+	if (!Entry.ImpactVFX && !Entry.ImpactDecal) return;
+
+	const float RadiusSq = FMath::Square(GetDefault<UPhysicsPropSettings>()->ImpactCoalesceRadius);
+
+	// Merge with a hit of the same effects already queued nearby this frame
+	for (FPropImpactVFXRequest& Request : PendingRequests)
+	{
+		if (Request.System == Entry.ImpactVFX && Request.Decal == Entry.ImpactDecal && FVector::DistSquared(Request.Location, Location) <= RadiusSq)
+		{
+			Request.Strength = FMath::Max(Request.Strength, Strength);
+			++NumRejected;
+			return;
+		}
+	}
+
+	FPropImpactVFXRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.System = Entry.ImpactVFX;
+	Request.Scale = Entry.VFXScale;
+	Request.Decal = Entry.ImpactDecal;
+	Request.DecalSize = Entry.DecalSize;
+	Request.DecalLifetime = Entry.DecalLifetime;
+	Request.Location = Location;
+	Request.Normal = Normal.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+	Request.Strength = Strength;
+}
+
+void FPropImpactVFXSpawner::Flush(UWorld* World)
+{
+	// Nobody sees anything on a dedicated server
+	if (!World || World->GetNetMode() == NM_DedicatedServer)
+	{
+		PendingRequests.Reset();
+		return;
+	}
+
+	const float CurrentTime = World->GetTimeSeconds();
+	ReleaseExpiredDecals(CurrentTime);
+
+	if (PendingRequests.Num() == 0) return;
+
+	const UPhysicsPropSettings* Settings = GetDefault<UPhysicsPropSettings>();
+
+	// Local views (split-screen)
+	TArray<FVector, TInlineAllocator<4>> Views;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLoc;
+			FRotator ViewRot;
+			PC->GetPlayerViewPoint(ViewLoc, ViewRot);
+			Views.Add(ViewLoc);
+		}
+	}
+
+	DistancesSq.SetNumUninitialized(PendingRequests.Num());
+	for (int32 Index = 0; Index < PendingRequests.Num(); ++Index)
+	{
+		float MinDistSq = Views.Num() > 0 ? MAX_flt : 0.0f;
+		for (const FVector& View : Views)
+		{
+			MinDistSq = FMath::Min(MinDistSq, FVector::DistSquared(View, PendingRequests[Index].Location));
+		}
+		DistancesSq[Index] = MinDistSq;
+	}
+
+	// Closest impacts first
+	TArray<int32, TInlineAllocator<64>> Order;
+	Order.SetNumUninitialized(PendingRequests.Num());
+	for (int32 Index = 0; Index < Order.Num(); ++Index)
+	{
+		Order[Index] = Index;
+	}
+	Order.Sort([this](int32 A, int32 B) { return DistancesSq[A] < DistancesSq[B]; });
+
+	const float CullDistSq = FMath::Square(Settings->ImpactVFXCullDistance);
+	int32 NumVFXThisFrame = 0;
+	int32 NumDecalsThisFrame = 0;
+	const int32 NumSpawnedBefore = NumSpawned;
+	const int32 NumRejectedBefore = NumRejected;
+
+	for (const int32 Index : Order)
+	{
+		const FPropImpactVFXRequest& Request = PendingRequests[Index];
+		bool bSpawned = false;
+
+		if (DistancesSq[Index] <= CullDistSq)
+		{
+			if (Request.System && NumVFXThisFrame < Settings->MaxImpactVFXPerFrame)
+			{
+				if (UNiagaraComponent* Component = AcquireVFXComponent(World))
+				{
+					// Changing the asset reinitializes the component, only do it when needed
+					if (Component->GetAsset() != Request.System)
+					{
+						Component->SetAsset(Request.System);
+					}
+					Component->SetWorldLocationAndRotation(Request.Location, Request.Normal.Rotation());
+					Component->SetWorldScale3D(FVector(Request.Scale));
+					Component->SetVariableFloat(PropImpactVFX::StrengthParameter, Request.Strength);
+					Component->Activate(true);
+
+					++NumVFXThisFrame;
+					bSpawned = true;
+				}
+			}
+
+			if (Request.Decal && NumDecalsThisFrame < Settings->MaxImpactDecalsPerFrame)
+			{
+				if (UDecalComponent* Component = AcquireDecalComponent(World))
+				{
+					// Random roll so repeated hits don't stamp the same pattern
+					FRotator DecalRotation = (-Request.Normal).Rotation();
+					DecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
+
+					Component->SetDecalMaterial(Request.Decal);
+					Component->DecalSize = Request.DecalSize;
+					Component->SetWorldLocationAndRotation(Request.Location, DecalRotation);
+					Component->SetFadeOut(Request.DecalLifetime, PropImpactVFX::DecalFadeDuration, false);
+					Component->SetVisibility(true);
+					DecalExpireTimes[DecalPool.IndexOfByKey(Component)] = CurrentTime + Request.DecalLifetime + PropImpactVFX::DecalFadeDuration;
+
+					++NumDecalsThisFrame;
+					bSpawned = true;
+				}
+			}
+		}
+
+		if (bSpawned)
+		{
+			++NumSpawned;
+		}
+		else
+		{
+			++NumRejected;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_PhysicsProps_ImpactVFXSpawned, NumSpawned - NumSpawnedBefore);
+	INC_DWORD_STAT_BY(STAT_PhysicsProps_ImpactVFXRejected, NumRejected - NumRejectedBefore);
+	CSV_CUSTOM_STAT(PhysicsProps, ImpactVFXSpawned, NumSpawned - NumSpawnedBefore, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(PhysicsProps, ImpactVFXRejected, NumRejected - NumRejectedBefore, ECsvCustomStatOp::Set);
+
+	PendingRequests.Reset();
+}
+
+UNiagaraComponent* FPropImpactVFXSpawner::AcquireVFXComponent(UWorld* World)
+{
+	// Idle components first, starting after the last one used
+	for (int32 Step = 0; Step < VFXPool.Num(); ++Step)
+	{
+		const int32 Index = (NextVFX + Step) % VFXPool.Num();
+		UNiagaraComponent* Component = VFXPool[Index];
+		if (Component && !Component->IsActive())
+		{
+			NextVFX = (Index + 1) % VFXPool.Num();
+			return Component;
+		}
+	}
+
+	if (VFXPool.Num() < GetDefault<UPhysicsPropSettings>()->ImpactVFXPoolSize)
+	{
+		UNiagaraComponent* Component = NewObject<UNiagaraComponent>(PropImpactVFX::GetPoolOuter(World));
+		Component->SetAutoActivate(false);
+		Component->SetAutoDestroy(false);
+		Component->RegisterComponentWithWorld(World);
+		VFXPool.Add(Component);
+		return Component;
+	}
+
+	// Pool full and busy: the oldest effect restarts here
+	UNiagaraComponent* Component = VFXPool[NextVFX];
+	NextVFX = (NextVFX + 1) % VFXPool.Num();
+	return Component;
+}
+
+UDecalComponent* FPropImpactVFXSpawner::AcquireDecalComponent(UWorld* World)
+{
+	for (int32 Step = 0; Step < DecalPool.Num(); ++Step)
+	{
+		const int32 Index = (NextDecal + Step) % DecalPool.Num();
+		if (DecalPool[Index] && DecalExpireTimes[Index] == 0.0f)
+		{
+			NextDecal = (Index + 1) % DecalPool.Num();
+			return DecalPool[Index];
+		}
+	}
+
+	if (DecalPool.Num() < GetDefault<UPhysicsPropSettings>()->ImpactDecalPoolSize)
+	{
+		UDecalComponent* Component = NewObject<UDecalComponent>(PropImpactVFX::GetPoolOuter(World));
+		Component->SetVisibility(false);
+		Component->RegisterComponentWithWorld(World);
+		DecalPool.Add(Component);
+		DecalExpireTimes.Add(0.0f);
+		return Component;
+	}
+
+	// Pool full: the oldest decal is moved here
+	UDecalComponent* Component = DecalPool[NextDecal];
+	NextDecal = (NextDecal + 1) % DecalPool.Num();
+	return Component;
+}
+
+void FPropImpactVFXSpawner::ReleaseExpiredDecals(float CurrentTime)
+{
+	for (int32 Index = 0; Index < DecalPool.Num(); ++Index)
+	{
+		if (DecalExpireTimes[Index] > 0.0f && CurrentTime >= DecalExpireTimes[Index])
+		{
+			DecalExpireTimes[Index] = 0.0f;
+			if (DecalPool[Index])
+			{
+				DecalPool[Index]->SetVisibility(false);
+			}
+		}
+	}
+}
+
+void FPropImpactVFXSpawner::Reset()
+{
+	for (UNiagaraComponent* Component : VFXPool)
+	{
+		if (Component)
+		{
+			Component->DestroyComponent();
+		}
+	}
+	for (UDecalComponent* Component : DecalPool)
+	{
+		if (Component)
+		{
+			Component->DestroyComponent();
+		}
+	}
+
+	PendingRequests.Reset();
+	VFXPool.Reset();
+	DecalPool.Reset();
+	DecalExpireTimes.Reset();
+	NextVFX = 0;
+	NextDecal = 0;
+	NumSpawned = 0;
+	NumRejected = 0;
+}
+
+void FPropImpactVFXSpawner::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObjects(VFXPool);
+	Collector.AddReferencedObjects(DecalPool);
+}
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropNetState.h"
+#include "Engine/NetSerialization.h"
+
+namespace PropNetState
+{
+	// Smallest three: the three smallest components of a unit quaternion are within +-1/sqrt(2)
+	constexpr float ComponentRange = UE_INV_SQRT_2;
+	constexpr uint32 ComponentBits = 10;
+	constexpr uint32 ComponentMax = (1u << ComponentBits) - 1;
+}
+
+void FPropNetState::Capture(const FTransform& Transform, const FVector& InLinearVelocity, const FVector& InAngularVelocity, bool bInAwake)
+{
+	// Snap to the precision of NetSerialize so that equality compares what would be sent
+	Location = Transform.GetLocation().GridSnap(0.1);
+	PackedRotation = PackRotation(Transform.GetRotation());
+	bAwake = bInAwake;
+	LinearVelocity = bAwake ? InLinearVelocity.GridSnap(1.0) : FVector::ZeroVector;
+	AngularVelocity = bAwake ? InAngularVelocity.GridSnap(1.0) : FVector::ZeroVector;
+}
+
+uint32 FPropNetState::PackRotation(const FQuat& Rotation)
+{
+	using namespace PropNetState;
+
+	const FQuat Normalized = Rotation.GetNormalized();
+	const float Components[4] = { (float)Normalized.X, (float)Normalized.Y, (float)Normalized.Z, (float)Normalized.W };
+
+	uint32 Largest = 0;
+	for (uint32 Index = 1; Index < 4; ++Index)
+	{
+		if (FMath::Abs(Components[Index]) > FMath::Abs(Components[Largest]))
+		{
+			Largest = Index;
+		}
+	}
+
+	// Flip the quaternion so the dropped component is positive
+	const float Sign = Components[Largest] < 0.0f ? -1.0f : 1.0f;
+
+	uint32 Packed = Largest;
+	uint32 Shift = 2;
+	for (uint32 Index = 0; Index < 4; ++Index)
+	{
+		if (Index == Largest) continue;
+
+		const float Normalized01 = (Components[Index] * Sign / ComponentRange + 1.0f) * 0.5f;
+		const uint32 Quantized = (uint32)FMath::Clamp(FMath::RoundToInt(Normalized01 * ComponentMax), 0, (int32)ComponentMax);
+		Packed |= Quantized << Shift;
+		Shift += ComponentBits;
+	}
+	return Packed;
+}
+
+FQuat FPropNetState::UnpackRotation(uint32 Packed)
+{
+	using namespace PropNetState;
+
+	const uint32 Largest = Packed & 3;
+
+	float Components[4];
+	float SumSquares = 0.0f;
+	uint32 Shift = 2;
+	for (uint32 Index = 0; Index < 4; ++Index)
+	{
+		if (Index == Largest) continue;
+
+		const uint32 Quantized = (Packed >> Shift) & ComponentMax;
+		Components[Index] = ((float)Quantized / ComponentMax * 2.0f - 1.0f) * ComponentRange;
+		SumSquares += FMath::Square(Components[Index]);
+		Shift += ComponentBits;
+	}
+	Components[Largest] = FMath::Sqrt(FMath::Max(1.0f - SumSquares, 0.0f));
+
+	return FQuat(Components[0], Components[1], Components[2], Components[3]).GetNormalized();
+}
+
+bool FPropNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = SerializePackedVector<10, 24>(Location, Ar);
+	Ar << PackedRotation;
+
+	uint8 bAwakeBit = bAwake ? 1 : 0;
+	Ar.SerializeBits(&bAwakeBit, 1);
+	bAwake = bAwakeBit != 0;
+
+	// A prop at rest has no velocity to send
+	if (bAwake)
+	{
+		bOutSuccess &= SerializePackedVector<1, 20>(LinearVelocity, Ar);
+		bOutSuccess &= SerializePackedVector<1, 20>(AngularVelocity, Ar);
+	}
+	else if (Ar.IsLoading())
+	{
+		LinearVelocity = FVector::ZeroVector;
+		AngularVelocity = FVector::ZeroVector;
+	}
+
+	return true;
+}
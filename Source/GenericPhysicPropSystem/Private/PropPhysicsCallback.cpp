@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropPhysicsCallback.h"
+#include "PBDRigidsSolver.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+#include "Chaos/Utilities.h"
+
+void FPropPhysicsCallback::SetCCDThreshold_External(int32 ParticleId, float ThresholdSq)
+{
+	if (ParticleId == INDEX_NONE) return;
+
+	GetProducerInputData_External()->CCDBodies.Add({ ParticleId, ThresholdSq });
+}
+
+void FPropPhysicsCallback::SetKinematicTarget_External(FSingleParticlePhysicsProxy* Proxy, const FTransform& Transform)
+{
+	if (!Proxy) return;
+
+	GetProducerInputData_External()->KinematicTargets.Add({ Proxy, Transform });
+}
+
+void FPropPhysicsCallback::AddImpulses_External(const FPropImpulseCommand& Command)
+{
+	if (!Command.Proxy) return;
+
+	GetProducerInputData_External()->Impulses.Add(Command);
+}
+
+void FPropPhysicsCallback::OnPreSimulate_Internal()
+{
+	Chaos::FPBDRigidsSolver* Solver = static_cast<Chaos::FPBDRigidsSolver*>(GetSolver());
+	FPropSimOutput& Output = GetProducerOutputData_Internal();
+
+	if (const FPropSimInput* Input = GetConsumerInput_Internal())
+	{
+		for (const FPropCCDBody& Body : Input->CCDBodies)
+		{
+			if (Body.ThresholdSq > 0.0f)
+			{
+				CCDThresholds.Add(Body.ParticleId, Body.ThresholdSq);
+			}
+			else
+			{
+				CCDThresholds.Remove(Body.ParticleId);
+			}
+		}
+
+		// Bodies removed since the command was queued have no physics thread handle anymore
+		for (const FPropKinematicTarget& Target : Input->KinematicTargets)
+		{
+			if (Chaos::FRigidBodyHandle_Internal* Handle = Target.Proxy->GetPhysicsThreadAPI())
+			{
+				Handle->SetKinematicTarget(Chaos::FKinematicTarget::MakePositionTarget(Target.Transform));
+			}
+		}
+
+		for (const FPropImpulseCommand& Command : Input->Impulses)
+		{
+			Chaos::FRigidBodyHandle_Internal* Handle = Command.Proxy->GetPhysicsThreadAPI();
+			if (!Handle) continue;
+
+			if (Handle->ObjectState() == Chaos::EObjectStateType::Sleeping && Command.bWake)
+			{
+				Handle->SetObjectState(Chaos::EObjectStateType::Dynamic);
+			}
+			if (Handle->ObjectState() != Chaos::EObjectStateType::Dynamic) continue;
+
+			// Impulses are velocity changes scaled by the inverse mass and inertia
+			const Chaos::FMatrix33 WorldInvInertia = Chaos::Utilities::ComputeWorldSpaceInertia(Handle->R() * Handle->RotationOfMass(), Chaos::FVec3(Handle->InvI()));
+			Handle->SetV(Handle->V() + Command.VelocityChange + Command.Impulse * Handle->InvM());
+			Handle->SetW(Handle->W() + WorldInvInertia * Command.AngularImpulse);
+		}
+	}
+
+	if (CCDThresholds.Num() == 0) return;
+
+	// Only the bodies moving right now, sleeping ones keep their CCD state
+	for (auto& Particle : Solver->GetParticles().GetActiveParticlesView())
+	{
+		const float* ThresholdSq = CCDThresholds.Find(Particle.UniqueIdx().Idx);
+		if (!ThresholdSq) continue;
+
+		const bool bFast = Particle.V().SizeSquared() > *ThresholdSq;
+		if (bFast != Particle.CCDEnabled())
+		{
+			Particle.Handle()->SetCCDEnabled(bFast);
+			++Output.NumCCDToggles;
+		}
+	}
+}
@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropPhysicsImpactData.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPropImpactData, Log, All);
+
+void UPropPhysicsImpactData::PostLoad()
+{
+	Super::PostLoad();
+
+	CompileImpactTable();
+}
+
+#if WITH_EDITOR
+void UPropPhysicsImpactData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Still works (matched by pointer), but other materials of that surface get no entry
+	TMap<uint8, const UPhysicalMaterial*> Surfaces;
+	for (const TPair<UPhysicalMaterial*, FImpactSoundEntry>& Pair : ImpactMap)
+	{
+		const EPhysicalSurface Surface = UPhysicalMaterial::DetermineSurfaceType(Pair.Key);
+		if (!Pair.Key || Surface == SurfaceType_Default) continue;
+
+		if (const UPhysicalMaterial* const* Other = Surfaces.Find(Surface))
+		{
+			UE_LOG(LogPropImpactData, Warning, TEXT("%s: ImpactMap keys %s and %s share Surface Type %d, each is only used for its own material."),
+				*GetName(), *GetNameSafe(*Other), *GetNameSafe(Pair.Key), (int32)Surface);
+		}
+		else
+		{
+			Surfaces.Add(Surface, Pair.Key);
+		}
+	}
+
+	CompileImpactTable();
+}
+#endif
+
+const FImpactSoundEntry& UPropPhysicsImpactData::FindImpactSound(EPhysicalSurface PropSurface, const UPhysicalMaterial* HitMaterial) const
+{
+	if (HitMaterial && MaterialColumns.Num() > 0)
+	{
+		if (const int32* Column = MaterialColumns.Find(HitMaterial))
+		{
+			return ResolvedEntries[MaterialLookup[*Column + PropSurface]];
+		}
+	}
+
+	const EPhysicalSurface HitSurface = UPhysicalMaterial::DetermineSurfaceType(HitMaterial);
+	return ResolvedEntries[LookupTable[PropSurface * SurfaceType_Max + HitSurface]];
+}
+
+void UPropPhysicsImpactData::CompileImpactTable()
+{
+	constexpr int32 NumSurfaces = SurfaceType_Max;
+	constexpr uint16 Unresolved = MAX_uint16;
+
+	ResolvedEntries.Reset();
+	ResolvedEntries.Add(DefaultSound);
+
+	// Indices are stored on 16 bits, MAX_uint16 being Unresolved
+	const auto AddEntry = [this](const FImpactSoundEntry& Entry) -> uint16
+	{
+		if (!ensureMsgf(ResolvedEntries.Num() < MAX_uint16, TEXT("%s: too many impact entries, the rest falls back to DefaultSound."), *GetName()))
+		{
+			return 0;
+		}
+		return static_cast<uint16>(ResolvedEntries.Add(Entry));
+	};
+
+	// ImpactMap keys per Surface Type. Without Surface Type (the default for every material) or shared
+	// with another key, the surface can't tell the materials apart: those keys are matched by pointer.
+	TMap<uint8, int32> KeysPerSurface;
+	for (const TPair<UPhysicalMaterial*, FImpactSoundEntry>& Pair : ImpactMap)
+	{
+		if (Pair.Key)
+		{
+			++KeysPerSurface.FindOrAdd(UPhysicalMaterial::DetermineSurfaceType(Pair.Key));
+		}
+	}
+
+	// Entries per hit surface (any prop) and per surface pair
+	TArray<uint16> HitSurfaceEntries;
+	HitSurfaceEntries.Init(Unresolved, NumSurfaces);
+
+	TArray<TPair<const UPhysicalMaterial*, uint16>> MaterialEntries;
+
+	for (const TPair<UPhysicalMaterial*, FImpactSoundEntry>& Pair : ImpactMap)
+	{
+		if (!Pair.Key) continue;
+
+		const EPhysicalSurface HitSurface = UPhysicalMaterial::DetermineSurfaceType(Pair.Key);
+		if (HitSurface == SurfaceType_Default || KeysPerSurface[HitSurface] > 1)
+		{
+			MaterialEntries.Emplace(Pair.Key, AddEntry(Pair.Value));
+		}
+		else
+		{
+			HitSurfaceEntries[HitSurface] = AddEntry(Pair.Value);
+		}
+	}
+
+	TArray<uint16> PairEntries;
+	PairEntries.Init(Unresolved, NumSurfaces * NumSurfaces);
+
+	for (const FImpactSurfacePairEntry& Entry : SurfacePairSounds)
+	{
+		PairEntries[Entry.PropSurface * NumSurfaces + Entry.HitSurface] = AddEntry(Entry.Sound);
+	}
+
+	// Resolve every fallback ahead of time
+	LookupTable.SetNumUninitialized(NumSurfaces * NumSurfaces);
+
+	for (int32 PropSurface = 0; PropSurface < NumSurfaces; ++PropSurface)
+	{
+		const uint16 PropDefault = PairEntries[PropSurface * NumSurfaces + SurfaceType_Default];
+
+		for (int32 HitSurface = 0; HitSurface < NumSurfaces; ++HitSurface)
+		{
+			uint16 Resolved = PairEntries[PropSurface * NumSurfaces + HitSurface];
+			if (Resolved == Unresolved)
+			{
+				Resolved = HitSurfaceEntries[HitSurface];
+			}
+			if (Resolved == Unresolved)
+			{
+				Resolved = PropDefault;
+			}
+			if (Resolved == Unresolved)
+			{
+				Resolved = 0; // DefaultSound
+			}
+			LookupTable[PropSurface * NumSurfaces + HitSurface] = Resolved;
+		}
+	}
+
+	// Materials matched by pointer: an exact pair of their surface still wins, then their own entry
+	MaterialColumns.Reset();
+	MaterialLookup.Reset();
+
+	for (const TPair<const UPhysicalMaterial*, uint16>& MaterialEntry : MaterialEntries)
+	{
+		const EPhysicalSurface HitSurface = UPhysicalMaterial::DetermineSurfaceType(MaterialEntry.Key);
+		const int32 Column = MaterialLookup.AddUninitialized(NumSurfaces);
+		MaterialColumns.Add(MaterialEntry.Key, Column);
+
+		for (int32 PropSurface = 0; PropSurface < NumSurfaces; ++PropSurface)
+		{
+			const uint16 Pair = HitSurface != SurfaceType_Default ? PairEntries[PropSurface * NumSurfaces + HitSurface] : Unresolved;
+			MaterialLookup[Column + PropSurface] = Pair != Unresolved ? Pair : MaterialEntry.Value;
+		}
+	}
+
+	// One sound bank per prop surface, from its resolved row
+	SoundBanks.Reset();
+	SoundBanks.SetNum(NumSurfaces);
+
+	const auto AddToBank = [this](int32 PropSurface, uint16 EntryIndex)
+	{
+		const TSoftObjectPtr<USoundBase>& Sound = ResolvedEntries[EntryIndex].ImpactSound;
+		if (!Sound.IsNull())
+		{
+			SoundBanks[PropSurface].AddUnique(Sound.ToSoftObjectPath());
+		}
+	};
+
+	for (int32 PropSurface = 0; PropSurface < NumSurfaces; ++PropSurface)
+	{
+		for (int32 HitSurface = 0; HitSurface < NumSurfaces; ++HitSurface)
+		{
+			AddToBank(PropSurface, LookupTable[PropSurface * NumSurfaces + HitSurface]);
+		}
+		for (int32 Column = 0; Column < MaterialLookup.Num(); Column += NumSurfaces)
+		{
+			AddToBank(PropSurface, MaterialLookup[Column + PropSurface]);
+		}
+	}
+}
@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropReplicationManager.h"
+#include "PhysicsPropSubsystem.h"
+#include "PhysicsPropSettings.h"
+#include "Net/UnrealNetwork.h"
+#include "Engine/World.h"
+
+namespace PropReplication
+{
+	// Time a settled prop stays in the array, so clients get its rest state before it is dropped
+	constexpr float SettledLingerTime = 1.0f;
+}
+
+void FPropReplicatedItem::PostReplicatedAdd(const FPropReplicatedArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->ReceivePropState(*this);
+	}
+}
+
+void FPropReplicatedItem::PostReplicatedChange(const FPropReplicatedArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->ReceivePropState(*this);
+	}
+}
+
+APropReplicationManager::APropReplicationManager()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	SetReplicatingMovement(false);
+	SetNetUpdateFrequency(GetDefault<UPhysicsPropSettings>()->NetUpdateFrequencyFull);
+}
+
+void APropReplicationManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(APropReplicationManager, States);
+}
+
+void APropReplicationManager::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	States.Owner = this;
+}
+
+void APropReplicationManager::UpdatePropState(uint32 PropId, const FPropNetState& State, float CurrentTime)
+{
+	const float RemoveTime = State.bAwake ? 0.0f : CurrentTime + PropReplication::SettledLingerTime;
+
+	if (const int32* ItemIndex = ItemIndices.Find(PropId))
+	{
+		FPropReplicatedItem& Item = States.Items[*ItemIndex];
+		if (Item.State == State) return;
+
+		Item.State = State;
+		Item.RemoveTime = RemoveTime;
+		States.MarkItemDirty(Item);
+		return;
+	}
+
+	FPropReplicatedItem& Item = States.Items.AddDefaulted_GetRef();
+	Item.PropId = PropId;
+	Item.State = State;
+	Item.RemoveTime = RemoveTime;
+	ItemIndices.Add(PropId, States.Items.Num() - 1);
+	States.MarkItemDirty(Item);
+}
+
+void APropReplicationManager::RemoveSettledProps(float CurrentTime)
+{
+	bool bRemoved = false;
+
+	for (int32 Index = States.Items.Num() - 1; Index >= 0; --Index)
+	{
+		const FPropReplicatedItem& Item = States.Items[Index];
+		if (Item.RemoveTime <= 0.0f || CurrentTime < Item.RemoveTime) continue;
+
+		ItemIndices.Remove(Item.PropId);
+		States.Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		if (States.Items.IsValidIndex(Index))
+		{
+			ItemIndices.Add(States.Items[Index].PropId, Index);
+		}
+		bRemoved = true;
+	}
+
+	if (bRemoved)
+	{
+		States.MarkArrayDirty();
+	}
+}
+
+void APropReplicationManager::RemoveProp(uint32 PropId)
+{
+	int32 Index = INDEX_NONE;
+	if (!ItemIndices.RemoveAndCopyValue(PropId, Index)) return;
+
+	States.Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (States.Items.IsValidIndex(Index))
+	{
+		ItemIndices.Add(States.Items[Index].PropId, Index);
+	}
+	States.MarkArrayDirty();
+}
+
+void APropReplicationManager::ReceivePropState(const FPropReplicatedItem& Item) const
+{
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		PropSubsystem->ReceiveNetPropState(Item.PropId, Item.State);
+	}
+}
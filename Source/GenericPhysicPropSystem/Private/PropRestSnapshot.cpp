@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropRestSnapshot.h"
+#include "PhysicsPropSubsystem.h"
+#include "PropStateSnapshot.h"
+#include "Components/BillboardComponent.h"
+#include "Engine/World.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+#if WITH_EDITOR
+#include "PhysicsPropComponent.h"
+#include "Editor.h"
+#include "EngineUtils.h"
+#include "Engine/LevelStreaming.h"
+#include "Misc/CoreMisc.h"
+#include "Misc/MessageDialog.h"
+#endif
+
+APropRestSnapshot::APropRestSnapshot()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+#if WITH_EDITORONLY_DATA
+	if (UBillboardComponent* Sprite = CreateEditorOnlyDefaultSubobject<UBillboardComponent>(TEXT("Sprite")))
+	{
+		Sprite->SetupAttachment(RootComponent);
+	}
+#endif
+}
+
+void APropRestSnapshot::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (SnapshotData.Num() == 0) return;
+
+	FPropStateSnapshot Snapshot;
+	FMemoryReader Reader(SnapshotData);
+	if (!Snapshot.Serialize(Reader)) return; // Baked with another version, bake again
+
+	if (UPhysicsPropSubsystem* PropSubsystem = GetWorld()->GetSubsystem<UPhysicsPropSubsystem>())
+	{
+		PropSubsystem->AddBakedPropStates(Snapshot);
+	}
+}
+
+#if WITH_EDITOR
+
+namespace PropRestSnapshot
+{
+	constexpr float BakeFrameTime = 1.0f / 60.0f;
+
+	// Frames every prop must stay asleep before the bake stops, sleep can flicker while a pile settles
+	constexpr int32 SettledFrames = 10;
+
+	// PIE instance of the bake world, far from the ones used by play sessions
+	constexpr int32 BakePIEInstance = 1000;
+}
+
+void APropRestSnapshot::BakeRestState()
+{
+	using namespace PropRestSnapshot;
+
+	UWorld* EditorWorld = GetWorld();
+	if (!GEditor || !EditorWorld || EditorWorld->WorldType != EWorldType::Editor) return;
+
+	if (GEditor->PlayWorld)
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, NSLOCTEXT("PhysicsProps", "BakeDuringPlay", "Stop the play session before baking prop rest states."));
+		return;
+	}
+
+	// Duplicate the level like a play session would, without a game instance or players
+	FWorldContext& BakeContext = GEngine->CreateNewWorldContext(EWorldType::PIE);
+	BakeContext.PIEInstance = BakePIEInstance;
+
+	UWorld* BakeWorld = nullptr;
+	{
+		FTemporaryPlayInEditorIDOverride PIEIDOverride(BakePIEInstance);
+		FString BakePackageName;
+		BakeWorld = GEditor->CreatePIEWorldByDuplication(BakeContext, EditorWorld, BakePackageName);
+		BakeContext.SetCurrentWorld(BakeWorld);
+		GEditor->PostCreatePIEWorld(BakeWorld);
+
+		for (ULevelStreaming* StreamingLevel : BakeWorld->GetStreamingLevels())
+		{
+			StreamingLevel->SetShouldBeLoaded(true);
+			StreamingLevel->SetShouldBeVisible(true);
+		}
+		BakeWorld->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+	}
+
+	// Nobody observes the bake world: no culling, every prop simulates at full LOD
+	for (TActorIterator<AActor> It(BakeWorld); It; ++It)
+	{
+		TInlineComponentArray<UPhysicsPropComponent*> PropComponents(*It);
+		for (UPhysicsPropComponent* Prop : PropComponents)
+		{
+			Prop->PhysicsCullDistance = 0.0f;
+		}
+	}
+
+	BakeWorld->InitializeActorsForPlay(FURL());
+	BakeWorld->BeginPlay();
+	BakeWorld->GetWorldSettings()->NotifyBeginPlay();
+
+	UPhysicsPropSubsystem* PropSubsystem = BakeWorld->GetSubsystem<UPhysicsPropSubsystem>();
+
+	const int32 MaxFrames = FMath::CeilToInt(MaxBakeTime / BakeFrameTime);
+	int32 Frame = 0;
+	int32 FramesAsleep = 0;
+	while (Frame < MaxFrames && FramesAsleep < SettledFrames)
+	{
+		BakeWorld->Tick(LEVELTICK_All, BakeFrameTime);
+		const bool bAllAsleep = PropSubsystem->GetNumPendingRegistrations() == 0 && PropSubsystem->GetNumAwakeProps() == 0;
+		FramesAsleep = bAllAsleep ? FramesAsleep + 1 : 0;
+		++Frame;
+	}
+
+	// Only the props of this actor's level, other levels have their own snapshot
+	const FString LevelPackageName = GetLevel()->GetOutermost()->GetName();
+	const ULevel* BakeLevel = nullptr;
+	for (const ULevel* Level : BakeWorld->GetLevels())
+	{
+		if (UWorld::RemovePIEPrefix(Level->GetOutermost()->GetName()) == LevelPackageName)
+		{
+			BakeLevel = Level;
+			break;
+		}
+	}
+
+	FPropStateSnapshot Snapshot;
+	if (BakeLevel)
+	{
+		PropSubsystem->CapturePropStates(Snapshot, BakeLevel);
+	}
+
+	// Whatever still moves is baked at rest
+	for (FPropStateRecord& Record : Snapshot.Records)
+	{
+		Record.bAwake = false;
+	}
+
+	BakeWorld->BeginTearingDown();
+	GEngine->DestroyWorldContext(BakeWorld);
+	BakeWorld->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	Modify();
+	SnapshotData.Reset();
+	FMemoryWriter Writer(SnapshotData);
+	Snapshot.Serialize(Writer);
+	NumBakedProps = Snapshot.Records.Num();
+	BakedSettleTime = Frame * BakeFrameTime;
+}
+
+void APropRestSnapshot::ClearRestState()
+{
+	Modify();
+	SnapshotData.Empty();
+	NumBakedProps = 0;
+	BakedSettleTime = 0.0f;
+}
+
+#endif // WITH_EDITOR
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropSpatialHashGrid.h"
+
+FPropSpatialHashGrid::FPropSpatialHashGrid(float InCellSize)
+{
+	SetCellSize(InCellSize);
+}
+
+void FPropSpatialHashGrid::SetCellSize(float InCellSize)
+{
+	check(Cells.Num() == 0);
+
+	CellSize = FMath::Max(InCellSize, 100.0f);
+	InvCellSize = 1.0f / CellSize;
+}
+
+FIntVector FPropSpatialHashGrid::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X * InvCellSize),
+		FMath::FloorToInt32(Location.Y * InvCellSize),
+		FMath::FloorToInt32(Location.Z * InvCellSize));
+}
+
+FIntVector FPropSpatialHashGrid::Add(int32 Id, const FVector& Location)
+{
+	const FIntVector Cell = GetCell(Location);
+	AddToCell(Id, Cell);
+	return Cell;
+}
+
+void FPropSpatialHashGrid::AddToCell(int32 Id, const FIntVector& Cell)
+{
+	Cells.FindOrAdd(Cell).Add(Id);
+	OccupiedMin = OccupiedMin.ComponentMin(Cell);
+	OccupiedMax = OccupiedMax.ComponentMax(Cell);
+}
+
+void FPropSpatialHashGrid::Remove(int32 Id, const FIntVector& Cell)
+{
+	if (TArray<int32>* CellIds = Cells.Find(Cell))
+	{
+		CellIds->RemoveSingleSwap(Id, EAllowShrinking::No);
+		if (CellIds->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+FIntVector FPropSpatialHashGrid::Move(int32 Id, const FIntVector& OldCell, const FVector& NewLocation)
+{
+	const FIntVector NewCell = GetCell(NewLocation);
+	if (NewCell != OldCell)
+	{
+		Remove(Id, OldCell);
+		AddToCell(Id, NewCell);
+	}
+	return NewCell;
+}
+
+void FPropSpatialHashGrid::Rename(int32 OldId, int32 NewId, const FIntVector& Cell)
+{
+	if (TArray<int32>* CellIds = Cells.Find(Cell))
+	{
+		const int32 Found = CellIds->Find(OldId);
+		if (Found != INDEX_NONE)
+		{
+			(*CellIds)[Found] = NewId;
+		}
+	}
+}
+
+void FPropSpatialHashGrid::Reset()
+{
+	Cells.Reset();
+	OccupiedMin = FIntVector(MAX_int32);
+	OccupiedMax = FIntVector(MIN_int32);
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropStateSnapshot.h"
+
+namespace PropStateSnapshot
+{
+	constexpr uint32 Magic = 0x50505353; // 'PPSS'
+	constexpr uint16 Version = 1;
+
+	// ID, location, rotation and flags of a prop at rest
+	constexpr int64 MinRecordSize = sizeof(uint32) + sizeof(FVector3f) + sizeof(FQuat4f) + sizeof(uint8);
+
+	enum ERecordFlags : uint8
+	{
+		RF_None  = 0,
+		RF_Awake = 1 << 0,
+	};
+}
+
+bool FPropStateSnapshot::Serialize(FArchive& Ar)
+{
+	int32 NumRecords = Records.Num();
+	if (!SerializeHeader(Ar, NumRecords)) return false;
+
+	if (Ar.IsLoading())
+	{
+		Records.SetNum(NumRecords);
+	}
+	for (FPropStateRecord& Record : Records)
+	{
+		SerializeRecord(Ar, Record);
+	}
+	return !Ar.IsError();
+}
+
+bool FPropStateSnapshot::SerializeHeader(FArchive& Ar, int32& NumRecords)
+{
+	uint32 Magic = PropStateSnapshot::Magic;
+	uint16 Version = PropStateSnapshot::Version;
+	Ar << Magic << Version << NumRecords;
+
+	// Old or foreign data, the props keep their current state
+	if (Ar.IsLoading() && (Ar.IsError() || Magic != PropStateSnapshot::Magic || Version != PropStateSnapshot::Version || NumRecords < 0))
+	{
+		NumRecords = 0;
+		return false;
+	}
+
+	// A corrupted count must not allocate more records than the data can hold
+	if (Ar.IsLoading() && Ar.TotalSize() >= 0 && NumRecords > (Ar.TotalSize() - Ar.Tell()) / PropStateSnapshot::MinRecordSize)
+	{
+		NumRecords = 0;
+		return false;
+	}
+	return true;
+}
+
+void FPropStateSnapshot::SerializeRecord(FArchive& Ar, FPropStateRecord& Record)
+{
+	using namespace PropStateSnapshot;
+
+	// Floats are plenty for props: under 0.1mm at a kilometer from the origin
+	FVector3f Location(Record.Location);
+	FQuat4f Rotation(Record.Rotation);
+	uint8 Flags = Record.bAwake ? RF_Awake : RF_None;
+
+	Ar << Record.PropId << Location << Rotation << Flags;
+
+	if (Ar.IsLoading())
+	{
+		Record.Location = FVector(Location);
+		Record.Rotation = FQuat(Rotation).GetNormalized();
+		Record.bAwake = (Flags & RF_Awake) != 0;
+	}
+
+	// Props at rest have no velocity to store
+	if (Record.bAwake)
+	{
+		FVector3f LinearVelocity(Record.LinearVelocity);
+		FVector3f AngularVelocity(Record.AngularVelocity);
+		Ar << LinearVelocity << AngularVelocity;
+
+		Record.LinearVelocity = FVector(LinearVelocity);
+		Record.AngularVelocity = FVector(AngularVelocity);
+	}
+	else if (Ar.IsLoading())
+	{
+		Record.LinearVelocity = FVector::ZeroVector;
+		Record.AngularVelocity = FVector::ZeroVector;
+	}
+}
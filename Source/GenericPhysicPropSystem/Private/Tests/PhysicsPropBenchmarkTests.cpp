@@ -0,0 +1,522 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PhysicsPropComponent.h"
+#include "PhysicsPropSubsystem.h"
+#include "PhysicsPropStats.h"
+#include "PropPhysicsImpactData.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/WorldSettings.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Sound/SoundWave.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/CommandLine.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/UObjectArray.h"
+
+// Headless benchmarks of the prop system, e.g.:
+//   UnrealEditor-Cmd <Project>.uproject -nullrhi -nosound -unattended
+//     -ExecCmds="Automation RunTests GenericPhysicPropSystem.Benchmarks; Quit"
+//     [-PropBenchmarkBaseline=<dir of a previous run>] [-PropBenchmarkThreshold=0.15]
+// Each scenario writes <Saved>/Automation/PhysicsPropBenchmarks/<Scenario>.json.
+// With a baseline, any metric worse than the baseline by more than the threshold fails the test.
+
+namespace PhysicsPropBenchmark
+{
+	constexpr float FrameTime = 1.0f / 60.0f;
+
+	// Noise floor under which a regression is ignored
+	constexpr double TimingSlackMs = 0.05;
+	constexpr double MemorySlackBytes = 256.0;
+
+	/** Transient game world ticked by hand. */
+	struct FBenchmarkWorld
+	{
+		UWorld* World = nullptr;
+
+		FBenchmarkWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("PhysicsPropBenchmark"));
+			FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+			Context.SetCurrentWorld(World);
+
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+			World->GetWorldSettings()->NotifyBeginPlay();
+		}
+
+		~FBenchmarkWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+
+		void Tick(int32 NumFrames = 1)
+		{
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				World->Tick(LEVELTICK_All, FrameTime);
+			}
+		}
+
+		UPhysicsPropSubsystem* GetProps() const { return World->GetSubsystem<UPhysicsPropSubsystem>(); }
+	};
+
+	/** Metrics of one scenario. */
+	struct FResult
+	{
+		FString Name;
+		int32 NumProps = 0;
+		int32 NumFrames = 0;
+		double GameThreadMs = 0.0;
+		double PhysicsMs = 0.0;
+		double FunctionMs[(int32)EPhysicsPropTiming::Num] = {};
+		int32 FunctionCalls[(int32)EPhysicsPropTiming::Num] = {};
+		double MemoryBytesPerProp = 0.0;
+		double ObjectsPerProp = 0.0;
+		int32 ImpactSoundsPlayed = 0;
+		int32 ImpactSoundsRejected = 0;
+	};
+
+	UStaticMesh* GetCubeMesh()
+	{
+		return LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	}
+
+	/** Static floor with its top at Z = 0. */
+	void SpawnFloor(UWorld* World, float HalfSize)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>(FVector(0.0f, 0.0f, -50.0f), FRotator::ZeroRotator, SpawnParams);
+		Floor->GetStaticMeshComponent()->SetStaticMesh(GetCubeMesh());
+		Floor->SetActorScale3D(FVector(HalfSize / 50.0f, HalfSize / 50.0f, 1.0f));
+	}
+
+	/** 50cm physics cube with a prop component. */
+	UPhysicsPropComponent* SpawnProp(UWorld* World, const FVector& Location, UPropPhysicsImpactData* ImpactTable = nullptr)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, SpawnParams);
+		UStaticMeshComponent* Mesh = Actor->GetStaticMeshComponent();
+		Mesh->SetMobility(EComponentMobility::Movable);
+		Mesh->SetStaticMesh(GetCubeMesh());
+		Mesh->SetWorldScale3D(FVector(0.5f));
+
+		UPhysicsPropComponent* Prop = NewObject<UPhysicsPropComponent>(Actor);
+		Prop->ImpactTable = ImpactTable;
+		Prop->RegisterComponent();
+		Prop->Physicalize(Mesh);
+		return Prop;
+	}
+
+	/** Props on a square grid resting on the floor, centered on the origin. */
+	TArray<UPhysicsPropComponent*> SpawnPropGrid(UWorld* World, int32 NumProps, float Spacing, float Height = 25.0f, UPropPhysicsImpactData* ImpactTable = nullptr)
+	{
+		const int32 Side = FMath::CeilToInt(FMath::Sqrt((float)NumProps));
+		const float Offset = (Side - 1) * Spacing * 0.5f;
+
+		TArray<UPhysicsPropComponent*> Props;
+		Props.Reserve(NumProps);
+		for (int32 Index = 0; Index < NumProps; ++Index)
+		{
+			const FVector Location((Index % Side) * Spacing - Offset, (Index / Side) * Spacing - Offset, Height);
+			Props.Add(SpawnProp(World, Location, ImpactTable));
+		}
+		return Props;
+	}
+
+	/** 
+	 * Records the memory and object cost of spawning props.
+	 * Memory is process wide (allocator growth, GC timing, physics scene): reported, never gated on.
+	 */
+	struct FSpawnCost
+	{
+		uint64 UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		int32 NumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+		void Finish(FResult& Result) const
+		{
+			if (Result.NumProps <= 0) return;
+
+			const int64 MemoryDelta = (int64)FPlatformMemory::GetStats().UsedPhysical - (int64)UsedPhysical;
+			Result.MemoryBytesPerProp = FMath::Max<int64>(MemoryDelta, 0) / (double)Result.NumProps;
+			Result.ObjectsPerProp = (GUObjectArray.GetObjectArrayNumMinusAvailable() - NumObjects) / (double)Result.NumProps;
+		}
+	};
+
+	/** Ticks the world for a number of frames, measuring everything. PerFrame runs before each tick. */
+	void Measure(FBenchmarkWorld& BenchWorld, int32 NumFrames, FResult& Result, TFunctionRef<void(int32)> PerFrame)
+	{
+		FPhysScene* PhysScene = BenchWorld.World->GetPhysicsScene();
+		UPhysicsPropSubsystem* PropSubsystem = BenchWorld.GetProps();
+		PropSubsystem->GetImpactAudio().Reset();
+
+		// Physics frame, from the solver kick-off to its completion
+		double PhysicsStart = 0.0;
+		double PhysicsSeconds = 0.0;
+		const FDelegateHandle PreTickHandle = PhysScene->OnPhysScenePreTick.AddLambda([&PhysicsStart](FPhysScene*, float)
+		{
+			PhysicsStart = FPlatformTime::Seconds();
+		});
+		const FDelegateHandle PostTickHandle = PhysScene->OnPhysScenePostTick.AddLambda([&PhysicsStart, &PhysicsSeconds](FPhysScene*)
+		{
+			PhysicsSeconds += FPlatformTime::Seconds() - PhysicsStart;
+		});
+
+		FPhysicsPropTimings::Reset();
+		FPhysicsPropTimings::bEnabled = true;
+
+		double GameThreadSeconds = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double FrameStart = FPlatformTime::Seconds();
+			PerFrame(Frame);
+			BenchWorld.Tick();
+			GameThreadSeconds += FPlatformTime::Seconds() - FrameStart;
+		}
+
+		FPhysicsPropTimings::bEnabled = false;
+		PhysScene->OnPhysScenePreTick.Remove(PreTickHandle);
+		PhysScene->OnPhysScenePostTick.Remove(PostTickHandle);
+
+		Result.NumFrames = NumFrames;
+		Result.GameThreadMs = GameThreadSeconds * 1000.0 / NumFrames;
+		Result.PhysicsMs = PhysicsSeconds * 1000.0 / NumFrames;
+		for (int32 Index = 0; Index < (int32)EPhysicsPropTiming::Num; ++Index)
+		{
+			Result.FunctionMs[Index] = FPhysicsPropTimings::Seconds[Index] * 1000.0 / NumFrames;
+			Result.FunctionCalls[Index] = FPhysicsPropTimings::Calls[Index];
+		}
+		Result.ImpactSoundsPlayed = PropSubsystem->GetImpactAudio().GetNumPlayed();
+		Result.ImpactSoundsRejected = PropSubsystem->GetImpactAudio().GetNumRejected();
+	}
+
+	void Measure(FBenchmarkWorld& BenchWorld, int32 NumFrames, FResult& Result)
+	{
+		Measure(BenchWorld, NumFrames, Result, [](int32) {});
+	}
+
+	/** Keeps props around the origin simulated, like a player standing there. */
+	void AddObserver(FBenchmarkWorld& BenchWorld)
+	{
+		AActor* Observer = BenchWorld.World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(FVector(0.0f, 0.0f, 200.0f)));
+		USceneComponent* Root = NewObject<USceneComponent>(Observer, TEXT("Root"));
+		Observer->SetRootComponent(Root);
+		Root->RegisterComponent();
+		BenchWorld.GetProps()->RegisterInterestSource(Observer);
+	}
+
+	// --- Scenarios ---
+
+	FResult RunRestingProps(int32 NumProps)
+	{
+		FBenchmarkWorld BenchWorld;
+		FResult Result;
+		Result.Name = FString::Printf(TEXT("RestingProps%dk"), NumProps / 1000);
+		Result.NumProps = NumProps;
+
+		SpawnFloor(BenchWorld.World, FMath::Sqrt((float)NumProps) * 60.0f);
+		AddObserver(BenchWorld);
+
+		const FSpawnCost SpawnCost;
+		SpawnPropGrid(BenchWorld.World, NumProps, 100.0f);
+		BenchWorld.Tick(120); // Settle
+		SpawnCost.Finish(Result);
+
+		Measure(BenchWorld, 120, Result);
+		return Result;
+	}
+
+	FResult RunMassExplosion()
+	{
+		FBenchmarkWorld BenchWorld;
+		FResult Result;
+		Result.Name = TEXT("MassExplosion");
+		Result.NumProps = 5000;
+
+		SpawnFloor(BenchWorld.World, 5000.0f);
+		AddObserver(BenchWorld);
+
+		const FSpawnCost SpawnCost;
+		SpawnPropGrid(BenchWorld.World, Result.NumProps, 100.0f);
+		BenchWorld.Tick(120);
+		SpawnCost.Finish(Result);
+
+		UPhysicsPropSubsystem* PropSubsystem = BenchWorld.GetProps();
+		Measure(BenchWorld, 120, Result, [PropSubsystem](int32 Frame)
+		{
+			if (Frame == 0)
+			{
+				PropSubsystem->ApplyExplosion(FVector::ZeroVector, 4000.0f, 100.0f, nullptr);
+			}
+		});
+		return Result;
+	}
+
+	FResult RunPileCollapse()
+	{
+		FBenchmarkWorld BenchWorld;
+		FResult Result;
+		Result.Name = TEXT("PileCollapse");
+		Result.NumProps = 1000;
+
+		SpawnFloor(BenchWorld.World, 2000.0f);
+		AddObserver(BenchWorld);
+
+		// 10x10 columns, 10 high, slightly off balance so they fall on each other
+		const FSpawnCost SpawnCost;
+		FRandomStream Random(1234);
+		for (int32 Index = 0; Index < Result.NumProps; ++Index)
+		{
+			const int32 Column = Index % 100;
+			const int32 Level = Index / 100;
+			const FVector Jitter(Random.FRandRange(-8.0f, 8.0f), Random.FRandRange(-8.0f, 8.0f), 0.0f);
+			SpawnProp(BenchWorld.World, FVector((Column % 10) * 55.0f - 250.0f, (Column / 10) * 55.0f - 250.0f, 25.0f + Level * 51.0f) + Jitter);
+		}
+		SpawnCost.Finish(Result);
+
+		Measure(BenchWorld, 300, Result);
+		return Result;
+	}
+
+	FResult RunGrabThrowCycles()
+	{
+		FBenchmarkWorld BenchWorld;
+		FResult Result;
+		Result.Name = TEXT("GrabThrowCycles");
+		Result.NumProps = 200;
+
+		SpawnFloor(BenchWorld.World, 2000.0f);
+		AddObserver(BenchWorld);
+
+		const FSpawnCost SpawnCost;
+		TArray<UPhysicsPropComponent*> Props = SpawnPropGrid(BenchWorld.World, Result.NumProps, 100.0f);
+		BenchWorld.Tick(60);
+		SpawnCost.Finish(Result);
+
+		AActor* Holder = BenchWorld.World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(FVector(0.0f, 0.0f, 150.0f)));
+		USceneComponent* Hand = NewObject<USceneComponent>(Holder, TEXT("Hand"));
+		Holder->SetRootComponent(Hand);
+		Hand->RegisterComponent();
+
+		// Grab a prop, hold it 10 frames, throw it, next one
+		Measure(BenchWorld, 600, Result, [&Props, Hand](int32 Frame)
+		{
+			UPhysicsPropComponent* Prop = Props[(Frame / 20) % Props.Num()];
+			if (Frame % 20 == 0)
+			{
+				Prop->Grab(Hand);
+			}
+			else if (Frame % 20 == 10)
+			{
+				Prop->Throw(FVector(1.0f, 0.0f, 0.5f), 1500.0f);
+			}
+			Hand->SetWorldRotation(FRotator(0.0f, Frame * 3.0f, 0.0f));
+		});
+		return Result;
+	}
+
+	FResult RunImpactStorm()
+	{
+		FBenchmarkWorld BenchWorld;
+		FResult Result;
+		Result.Name = TEXT("ImpactStorm");
+		Result.NumProps = 2000;
+
+		SpawnFloor(BenchWorld.World, 3000.0f);
+		AddObserver(BenchWorld);
+
+		// Sounds are soft references, this one must stay alive on its own
+		TStrongObjectPtr<USoundWave> Sound(NewObject<USoundWave>());
+		UPropPhysicsImpactData* ImpactTable = NewObject<UPropPhysicsImpactData>();
+		ImpactTable->DefaultSound.ImpactSound = Sound.Get();
+		ImpactTable->CompileImpactTable();
+
+		// Props rain down in layers and bounce on each other
+		const FSpawnCost SpawnCost;
+		for (int32 Layer = 0; Layer < 4; ++Layer)
+		{
+			for (UPhysicsPropComponent* Prop : SpawnPropGrid(BenchWorld.World, Result.NumProps / 4, 70.0f, 300.0f + Layer * 150.0f, ImpactTable))
+			{
+				Prop->MinImpactThreshold = 10.0f;
+			}
+		}
+		SpawnCost.Finish(Result);
+
+		Measure(BenchWorld, 240, Result);
+		return Result;
+	}
+
+	// --- Output ---
+
+	TSharedRef<FJsonObject> ToJson(const FResult& Result)
+	{
+		TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetStringField(TEXT("scenario"), Result.Name);
+		Json->SetNumberField(TEXT("props"), Result.NumProps);
+		Json->SetNumberField(TEXT("frames"), Result.NumFrames);
+		Json->SetNumberField(TEXT("gameThreadMsPerFrame"), Result.GameThreadMs);
+		Json->SetNumberField(TEXT("physicsMsPerFrame"), Result.PhysicsMs);
+		Json->SetNumberField(TEXT("memoryBytesPerProp"), Result.MemoryBytesPerProp);
+		Json->SetNumberField(TEXT("objectsPerProp"), Result.ObjectsPerProp);
+		Json->SetNumberField(TEXT("impactSoundsPlayed"), Result.ImpactSoundsPlayed);
+		Json->SetNumberField(TEXT("impactSoundsRejected"), Result.ImpactSoundsRejected);
+
+		TSharedRef<FJsonObject> Functions = MakeShared<FJsonObject>();
+		for (int32 Index = 0; Index < (int32)EPhysicsPropTiming::Num; ++Index)
+		{
+			TSharedRef<FJsonObject> Function = MakeShared<FJsonObject>();
+			Function->SetNumberField(TEXT("msPerFrame"), Result.FunctionMs[Index]);
+			Function->SetNumberField(TEXT("calls"), Result.FunctionCalls[Index]);
+			Functions->SetObjectField(FPhysicsPropTimings::GetName((EPhysicsPropTiming)Index), Function);
+		}
+		Json->SetObjectField(TEXT("functions"), Functions);
+		return Json;
+	}
+
+	FString GetOutputDir()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("PhysicsPropBenchmarks");
+	}
+
+	bool WriteJson(const TSharedRef<FJsonObject>& Json, const FString& Path)
+	{
+		FString Text;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+		return FJsonSerializer::Serialize(Json, Writer) && FFileHelper::SaveStringToFile(Text, *Path);
+	}
+
+	TSharedPtr<FJsonObject> ReadJson(const FString& Path)
+	{
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *Path)) return nullptr;
+
+		TSharedPtr<FJsonObject> Json;
+		FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Json);
+		return Json;
+	}
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FPhysicsPropBenchmarkTest, "GenericPhysicPropSystem.Benchmarks",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FPhysicsPropBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const TCHAR* Scenarios[] = {
+		TEXT("RestingProps1k"),
+		TEXT("RestingProps5k"),
+		TEXT("RestingProps20k"),
+		TEXT("MassExplosion"),
+		TEXT("PileCollapse"),
+		TEXT("GrabThrowCycles"),
+		TEXT("ImpactStorm"),
+	};
+
+	for (const TCHAR* Scenario : Scenarios)
+	{
+		OutBeautifiedNames.Add(Scenario);
+		OutTestCommands.Add(Scenario);
+	}
+}
+
+bool FPhysicsPropBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace PhysicsPropBenchmark;
+
+	FResult Result;
+	if (Parameters == TEXT("RestingProps1k"))		Result = RunRestingProps(1000);
+	else if (Parameters == TEXT("RestingProps5k"))	Result = RunRestingProps(5000);
+	else if (Parameters == TEXT("RestingProps20k"))	Result = RunRestingProps(20000);
+	else if (Parameters == TEXT("MassExplosion"))	Result = RunMassExplosion();
+	else if (Parameters == TEXT("PileCollapse"))	Result = RunPileCollapse();
+	else if (Parameters == TEXT("GrabThrowCycles"))	Result = RunGrabThrowCycles();
+	else if (Parameters == TEXT("ImpactStorm"))		Result = RunImpactStorm();
+	else
+	{
+		AddError(FString::Printf(TEXT("Unknown scenario %s"), *Parameters));
+		return false;
+	}
+
+	const TSharedRef<FJsonObject> Json = ToJson(Result);
+	const FString OutputPath = GetOutputDir() / (Result.Name + TEXT(".json"));
+	if (!WriteJson(Json, OutputPath))
+	{
+		AddError(FString::Printf(TEXT("Could not write %s"), *OutputPath));
+	}
+	AddInfo(FString::Printf(TEXT("%s: %.3f ms game thread, %.3f ms physics per frame, %.0f bytes per prop -> %s"),
+		*Result.Name, Result.GameThreadMs, Result.PhysicsMs, Result.MemoryBytesPerProp, *OutputPath));
+
+	// Compare against a previous run
+	FString BaselineDir;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("PropBenchmarkBaseline="), BaselineDir)) return true;
+
+	const TSharedPtr<FJsonObject> Baseline = ReadJson(BaselineDir / (Result.Name + TEXT(".json")));
+	if (!Baseline.IsValid())
+	{
+		AddWarning(FString::Printf(TEXT("No baseline for %s in %s"), *Result.Name, *BaselineDir));
+		return true;
+	}
+
+	double Threshold = 0.15;
+	FParse::Value(FCommandLine::Get(), TEXT("PropBenchmarkThreshold="), Threshold);
+
+	auto CheckMetric = [this, &Result, Threshold](const FString& Metric, double Current, double Base, double Slack, bool bWarnOnly = false)
+	{
+		const double Limit = Base * (1.0 + Threshold) + Slack;
+		if (Current > Limit)
+		{
+			const FString Message = FString::Printf(TEXT("%s regressed on %s: %.4f, baseline %.4f (limit %.4f)"), *Result.Name, *Metric, Current, Base, Limit);
+			if (bWarnOnly)
+			{
+				AddWarning(Message);
+			}
+			else
+			{
+				AddError(Message);
+			}
+		}
+	};
+
+	CheckMetric(TEXT("gameThreadMsPerFrame"), Result.GameThreadMs, Baseline->GetNumberField(TEXT("gameThreadMsPerFrame")), TimingSlackMs);
+	CheckMetric(TEXT("physicsMsPerFrame"), Result.PhysicsMs, Baseline->GetNumberField(TEXT("physicsMsPerFrame")), TimingSlackMs);
+
+	// Too noisy to fail on, see FSpawnCost
+	CheckMetric(TEXT("memoryBytesPerProp"), Result.MemoryBytesPerProp, Baseline->GetNumberField(TEXT("memoryBytesPerProp")), MemorySlackBytes, true);
+
+	const TSharedPtr<FJsonObject>* BaseFunctions = nullptr;
+	if (Baseline->TryGetObjectField(TEXT("functions"), BaseFunctions))
+	{
+		for (int32 Index = 0; Index < (int32)EPhysicsPropTiming::Num; ++Index)
+		{
+			const TCHAR* FunctionName = FPhysicsPropTimings::GetName((EPhysicsPropTiming)Index);
+			const TSharedPtr<FJsonObject>* BaseFunction = nullptr;
+			if ((*BaseFunctions)->TryGetObjectField(FunctionName, BaseFunction))
+			{
+				CheckMetric(FunctionName, Result.FunctionMs[Index], (*BaseFunction)->GetNumberField(TEXT("msPerFrame")), TimingSlackMs);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -5,8 +5,43 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "PropPhysicsImpactData.h"
+#include "PhysicsPropDamageType.h"
+#include "PropNetState.h"
+#include "PropStateSnapshot.h"
+#include "WorldCollision.h"
 #include "PhysicsPropComponent.generated.h"
 
+class FPropPhysicsCallback;
+class FSingleParticlePhysicsProxy;
+class UBodySetup;
+class UPhysicalMaterial;
+
+/** Physics level of detail of a prop, picked by UPhysicsPropSubsystem from the distance to the closest observer. */
+UENUM(BlueprintType)
+enum class EPropPhysicsLOD : uint8
+{
+	/** Full simulation. */
+	Full,
+	/** Simulated with fewer solver iterations and more damping. */
+	Reduced,
+	/** Not simulated, frozen in place but still collides (kinematic). */
+	Frozen,
+	/** No body in the physics scene at all. */
+	Dormant,
+};
+
+/** How a grabbed prop follows its holder. */
+UENUM(BlueprintType)
+enum class EPropGrabMode : uint8
+{
+	/** Simulation is turned off while held and the actor is moved directly. */
+	Teleport,
+	/** 
+	 * The body keeps simulating and is pulled toward the hold target by a spring (physics handle),
+	 * the target being moved kinematically every physics step. No rigid body state is torn down on grab or release.
+	 */
+	PhysicsHandle,
+};
 
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class GENERICPHYSICPROPSYSTEM_API UPhysicsPropComponent : public UActorComponent
@@ -16,12 +51,15 @@ class GENERICPHYSICPROPSYSTEM_API UPhysicsPropComponent : public UActorComponent
 public:
 	UPhysicsPropComponent();
 
-	/** Distance in centimeters at which physics (and ticking) logic is optimized/disabled. 0 = Infinite. */
+	/** 
+	 * Distance in centimeters at which physics (and ticking) logic is optimized/disabled. 0 = Infinite.
+	 * The physics LOD tiers (Reduced, Frozen, Dormant) are multiples of this distance, see the project settings.
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Optimization")
 	float PhysicsCullDistance = 3000.0f; // Default 30m
 
-	/** Frequency in seconds to check the distance between the player and this object. */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Optimization")
+	/** Deprecated: distance checks are now batched by UPhysicsPropSubsystem, see CullInterval in the project settings. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Optimization", meta = (DeprecatedProperty, DeprecationMessage = "Use CullInterval in the Generic Physic Prop System project settings."))
 	float DistanceCheckInterval = 1.0f;
 
 	/** 
@@ -31,9 +69,17 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Collision")
 	float CCDSpeedThreshold = 500.0f; 
 
+	/** 
+	 * If true, sleep and wake drive the owner's net dormancy, and awake props replicate a quantized state
+	 * at a rate set by their physics LOD instead of FRepMovement. The owner must replicate.
+	 * The component only replicates in this mode.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Networking")
+	bool bQuantizedReplication = false;
+
 	// Audio Configuration
 	
-	/** Data Asset containing impact sounds per Physical Material. */
+	/** Data Asset containing impact sounds, particles and decals per Physical Material. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Audio")
 	UPropPhysicsImpactData* ImpactTable;
 
@@ -48,8 +94,34 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Audio")
 	float ImpactCooldown = 0.1f;
 
+	/** Maximum number of impact sounds this prop can start over any one second window. 0 = only the cooldown limits it. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Audio", meta = (ClampMin = "0"))
+	int32 MaxImpactsPerSecond = 0;
+
 	// --- Interaction Mechanics (Grab/Throw) ---
 
+	/** 
+	 * If true, the anti-clipping sweep of a held object is asynchronous (one frame of latency)
+	 * and uses the object's simplified collision instead of a small sphere.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Interaction")
+	bool bAsyncGrabSweep = true;
+
+	/** 
+	 * How the object follows its holder. PhysicsHandle avoids the solver hitches of toggling simulation
+	 * when objects are grabbed and dropped often, and keeps the object's true velocity on release.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Interaction")
+	EPropGrabMode GrabMode = EPropGrabMode::Teleport;
+
+	/** Stiffness of the spring pulling the object to the hold position, PhysicsHandle mode only. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Interaction", meta = (ClampMin = "0.0", EditCondition = "GrabMode == EPropGrabMode::PhysicsHandle"))
+	float GrabLinearStiffness = 750.0f;
+
+	/** Stiffness of the spring aligning the object to the hold rotation, PhysicsHandle mode only. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jam Physics|Interaction", meta = (ClampMin = "0.0", EditCondition = "GrabMode == EPropGrabMode::PhysicsHandle"))
+	float GrabAngularStiffness = 1500.0f;
+
 	/** 
 	 * Grabs the object and attaches it to the specified component (e.g., player hand or SceneComponent in front of camera).
 	 * @param Holder The scene component that will hold the object.
@@ -73,6 +145,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Jam Physics|Interaction")
 	bool IsGrabbed() const { return bIsGrabbed; }
 
+	/** Returns true while the object waits in the prop pool (hidden, not simulated). */
+	UFUNCTION(BlueprintPure, Category = "Jam Physics|Pooling")
+	bool IsPooled() const { return bPooled; }
+
+	/** Returns the current physics level of detail of the object. */
+	UFUNCTION(BlueprintPure, Category = "Jam Physics|Optimization")
+	EPropPhysicsLOD GetPhysicsLOD() const { return PhysicsLOD; }
+
 	/** 
 	 * Initializes physics on the target mesh.
 	 * Sets up collision notifications, sleep events, and optimization settings.
@@ -81,14 +161,71 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Jam Physics")
 	void Physicalize(UStaticMeshComponent* TargetMesh);
 
+	/** 
+	 * ID of a prop actor that is identical in the editor, in PIE, on the server and on clients, and across sessions
+	 * for level-placed actors. Used by aggregated replication and state snapshots.
+	 */
+	static uint32 MakeStableId(const AActor* Actor);
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
-	/** Timer function to check distance to player for optimization. */
-	void CheckDistanceToPlayer();
+	/** 
+	 * Called by the prop subsystem to move the prop to another physics LOD tier.
+	 * @param NewLOD The tier to switch to.
+	 * @return False if the prop can't change tier right now (e.g. grabbed).
+	 */
+	bool ApplyPhysicsLOD(EPropPhysicsLOD NewLOD);
+
+	/** 
+	 * Called by the prop subsystem to rebuild the body of the prop with another collision shape.
+	 * The body keeps its mass, its velocity and its sleep state.
+	 * @param SimpleSetup Shared simple collision, or null for the authored collision of the mesh.
+	 * @return False if the body can't be rebuilt right now (e.g. grabbed, welded or without body).
+	 */
+	bool ApplyCollisionLOD(UBodySetup* SimpleSetup);
+
+	/** Brings a frozen or dormant prop back to full simulation, e.g. when it gets damaged. */
+	void PromoteToFullLOD();
+
+	/** Physicalizes a prop queued by BeginPlay for deferred registration. Does nothing if it isn't queued anymore or left play. */
+	void PhysicalizeDeferred();
+
+	/** Binds the owner's damage events, queued props included so damage physicalizes them on the spot. */
+	void BindDamageEvents();
+
+	/** Reads the Surface Type of the managed mesh's physical material into PropSurface, e.g. after a mesh swap. */
+	void CachePropSurface();
+
+	/** Clears grab, damage and LOD state, then hides the prop and takes it out of the physics scene. */
+	void DeactivateForPool();
+
+	/** 
+	 * Brings a pooled prop back, simulated and at rest, with the surface of its current mesh.
+	 * @param Transform Where the prop appears.
+	 */
+	void ReactivateFromPool(const FTransform& Transform);
+
+	/** 
+	 * Teleports the prop to a snapshot state, then gives it the snapshot velocities or puts it to sleep.
+	 * Frozen and dormant props are only moved, they get their velocities back from the LOD pass.
+	 */
+	void ApplyPropState(const FPropStateRecord& Record);
+
+	/** 
+	 * Server only: net dormancy and update rate of the owner for a physics state.
+	 * @param bAwake False flushes the rest state and makes the owner dormant.
+	 */
+	void SetNetAwake(bool bAwake);
 
-	FTimerHandle TimerHandle_DistanceCheck;
+	/** Applies the replicated state to the local body. */
+	UFUNCTION()
+	void OnRep_NetState();
 
 	/** Callback when the physics component falls asleep. */
 	UFUNCTION()
@@ -98,6 +235,21 @@ protected:
 	UFUNCTION()
 	void OnPhysicsComponentWake(UPrimitiveComponent* WakingComponent, FName BoneName);
 
+	/** Returns the damage response of a damage type, cached by the subsystem when there is one. */
+	const FPropDamageResponse& GetDamageResponse(const UDamageType* DamageType, FPropDamageResponse& Fallback) const;
+
+	/** 
+	 * Accumulates a damage impulse, applied with the other damage of the frame by FlushDamageImpulses.
+	 * @param VelocityChange Mass independent impulse through the center of mass.
+	 * @param Impulse Mass dependent impulse through the center of mass.
+	 * @param AngularImpulse Mass dependent angular impulse (radians).
+	 * @param bWake Whether the body should be woken up.
+	 */
+	void AddDamageImpulse(const FVector& VelocityChange, const FVector& Impulse, const FVector& AngularImpulse, bool bWake);
+
+	/** Applies the accumulated damage impulses with one wake and one call per impulse kind. */
+	void FlushDamageImpulses();
+
 	/** Callback for AnyDamage to wake up the object and apply generic forces. */
 	UFUNCTION()
 	void OnTakeAnyDamage(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
@@ -110,6 +262,15 @@ protected:
 	UFUNCTION()
 	void OnTakeRadialDamage(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, FVector Origin, const FHitResult& HitInfo, class AController* InstigatedBy, AActor* DamageCauser);
 
+	/** 
+	 * Plays the impact sound of a hit, unless filtered by the threshold, the cooldown or the rate limit.
+	 * @param ImpactIntensity Impulse divided by the prop's mass.
+	 * @param Location Contact point.
+	 * @param Normal Contact normal, orients the impact particles and decal.
+	 * @param HitMaterial Physical material of what the prop hit, may be null.
+	 */
+	void HandleImpact(float ImpactIntensity, const FVector& Location, const FVector& Normal, const UPhysicalMaterial* HitMaterial);
+
 	/** Callback for collision hits to trigger audio effects. */
 	UFUNCTION()
 	void OnComponentHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
@@ -119,12 +280,105 @@ protected:
 	/** Updates the position of the grabbed object, handling collision with walls to prevent clipping. */
 	void UpdateGrabbedPosition();
 
+	/** Physics thread callback of the prop subsystem, null if disabled. */
+	FPropPhysicsCallback* GetPhysicsCallback() const;
+
+	/** Physics proxy of the managed mesh's body, null while it has none (e.g. Dormant). */
+	FSingleParticlePhysicsProxy* GetPhysicsProxy() const;
+
+	/** Builds the sweep shape of the held object from its simplified collision (single primitive) or its bounds, placed relative to the owner. */
+	void CacheGrabSweepShape();
+
+	/** Sets the solver iterations and damping of the Full or Reduced tier on the prop's own body, simulating it. */
+	void ApplyTierBodySettings();
+
 private:
+	friend class UPhysicsPropSubsystem;
+
 	UPROPERTY()
 	UStaticMeshComponent* ManagedMesh;
 
+	/** Mesh to physicalize once the subsystem processes the registration queue, kinematic until then. */
+	UPROPERTY()
+	UStaticMeshComponent* DeferredMesh = nullptr;
+
+	/** Slot of this prop in the subsystem buffers. INDEX_NONE if not registered. */
+	int32 PropIndex = INDEX_NONE;
+
+	/** Entry of this prop in the subsystem's registration queue. INDEX_NONE if not queued. */
+	int32 RegistrationSlot = INDEX_NONE;
+
+	/** Stable ID matching this prop on the server and on clients, aggregated replication only. 0 = none. */
+	uint32 NetId = 0;
+
+	/** MakeStableId of the owner, set by Physicalize. */
+	uint32 StableId = 0;
+
+	/** Particle whose CCD the physics thread callback switches, INDEX_NONE if none. */
+	int32 CCDParticleId = INDEX_NONE;
+
+	/** Server: next time the state of this prop goes to the replication manager. */
+	float NextNetStateTime = 0.0f;
+
 	float LastImpactTime = 0.0f;
 
+	// Impacts played in the current one second window, for MaxImpactsPerSecond
+	float ImpactWindowStart = 0.0f;
+	int32 NumImpactsInWindow = 0;
+
+	EPropPhysicsLOD PhysicsLOD = EPropPhysicsLOD::Full;
+
+	/** World time until which the LOD pass keeps the prop in Full, set by PromoteToFullLOD. */
+	float FullLODHoldUntilTime = 0.0f;
+
+	// Body settings of the Full tier, restored when leaving the Reduced tier
+	float FullLinearDamping = 0.0f;
+	float FullAngularDamping = 0.0f;
+	uint8 FullPositionIterations = 8;
+	uint8 FullVelocityIterations = 1;
+
+	// Mass settings of the authored collision, the simple one keeps its mass through an override
+	float FullMassInKg = 0.0f;
+	bool bFullOverrideMass = false;
+
+	// Damage impulses accumulated during the frame
+	FVector PendingDamageVelocityChange = FVector::ZeroVector;
+	FVector PendingDamageImpulse = FVector::ZeroVector;
+	FVector PendingDamageAngularImpulse = FVector::ZeroVector;
+	bool bPendingDamageWake = false;
+	bool bDamageFlushQueued = false;
+
+	/** World time at which the prop last fell asleep, or left a weld group. */
+	float AsleepSinceTime = 0.0f;
+
+	/** Weld group of the subsystem this prop belongs to, INDEX_NONE if it has its own body. */
+	int32 WeldGroup = INDEX_NONE;
+
+	/** World time at which the prop entered the Dormant tier. */
+	float DormantSinceTime = 0.0f;
+
+	/** True while the prop waits in the subsystem's pool. */
+	bool bPooled = false;
+
+	/** Collision of the mesh before it was pooled. */
+	TEnumAsByte<ECollisionEnabled::Type> PooledCollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+
+	/** True while the prop is hidden and drawn by an instance of the subsystem's proxies. */
+	bool bHibernated = false;
+
+	/** Index of the proxy instance drawing the prop while hibernated, INDEX_NONE otherwise. */
+	int32 ProxyInstance = INDEX_NONE;
+
+	/** Collision of the mesh before it went dormant. */
+	TEnumAsByte<ECollisionEnabled::Type> DormantCollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+
+	/** Quantized state sent to clients while the prop is awake. */
+	UPROPERTY(ReplicatedUsing = OnRep_NetState)
+	FPropNetState NetState;
+
+	/** Surface Type of the mesh's physical material, row of the impact table lookup. */
+	TEnumAsByte<EPhysicalSurface> PropSurface = SurfaceType_Default;
+
 	// Grab State
 	bool bIsGrabbed = false;
 
@@ -133,4 +387,33 @@ private:
 
 	/** Ideal hold distance calculated during Grab. */
 	float HoldDistance = 0.0f;
+
+	/** Mode of the current grab, GrabMode may change while held. */
+	EPropGrabMode ActiveGrabMode = EPropGrabMode::Teleport;
+
+	/** Spring used by the PhysicsHandle mode, created on the owner at the first grab. */
+	UPROPERTY()
+	class UPhysicsHandleComponent* GrabHandle = nullptr;
+
+	/** bUpdateKinematicFromSimulation of the body before the grab, forced while the physics thread moves it. */
+	bool bHeldKinematicFromSimulation = false;
+
+	/** Response of the mesh to pawns before the grab, a simulated held object must not push its holder. */
+	TEnumAsByte<ECollisionResponse> HeldPawnResponse = ECR_Block;
+
+	// Async anti-clipping sweep, cached for the duration of the grab
+	FCollisionQueryParams GrabQueryParams;
+	FCollisionShape GrabSweepShape;
+
+	/** Center of the sweep shape relative to the owner, in the owner's rotation frame (world scale). */
+	FVector GrabShapeOffset = FVector::ZeroVector;
+
+	/** Rotation of the sweep shape relative to the owner. */
+	FQuat GrabShapeRotation = FQuat::Identity;
+
+	/** Sweep issued last frame, read this frame. */
+	FTraceHandle GrabTraceHandle;
+
+	/** Fraction of the hold distance free of obstacles, from the last completed sweep. */
+	float GrabSafeFraction = 1.0f;
 };
@@ -6,6 +6,18 @@
 #include "GameFramework/DamageType.h"
 #include "PhysicsPropDamageType.generated.h"
 
+/** Impulse multipliers of a damage type for every kind of damage event, resolved once per damage class. */
+struct FPropDamageResponse
+{
+	float AnyDamageMultiplier = 500.0f;
+	float PointDamageMultiplier = 500.0f;
+	float RadialDamageMultiplier = 2000.0f;
+	bool bShouldWake = true;
+
+	/** Runs the damage type cast chain. */
+	static FPropDamageResponse Resolve(const UDamageType* DamageType);
+};
+
 /**
  * Custom DamageType for the Jam Physics System.
  * Allows defining an impact force independent of damage (HP).
@@ -26,4 +38,14 @@ public:
 	/** If true, the object will be woken up even if it was asleep. */
 	UPROPERTY(EditDefaultsOnly, Category = "Jam Physics")
 	bool bForceWake = true;
+
+	/** 
+	 * Resolves how any damage type pushes props (unified DamageType handling).
+	 * @param DamageType UPhysicsPropDamageType, UGenericDamageType or any other damage type. Can be null.
+	 * @param BaseMultiplier Impulse per damage point of damage types without physics settings.
+	 * @param PropDamageScale Scale applied to ImpulsePower when DamageType is a UPhysicsPropDamageType.
+	 * @param bOutShouldWake Whether the damage should wake sleeping props.
+	 * @return Impulse per damage point.
+	 */
+	static float ResolveImpulseMultiplier(const UDamageType* DamageType, float BaseMultiplier, float PropDamageScale, bool& bOutShouldWake);
 };
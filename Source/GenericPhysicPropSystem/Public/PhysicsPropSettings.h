@@ -0,0 +1,329 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "PhysicsPropSettings.generated.h"
+
+/**
+ * Project-wide settings for the physics prop system.
+ * Found under Project Settings -> Plugins -> Generic Physic Prop System.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Generic Physic Prop System"))
+class GENERICPHYSICPROPSYSTEM_API UPhysicsPropSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UPhysicsPropSettings();
+
+	/** Frequency in seconds of the batched distance / physics LOD pass run by the prop subsystem. */
+	UPROPERTY(Config, EditAnywhere, Category = "Optimization", meta = (ClampMin = "0.0"))
+	float CullInterval = 0.5f;
+
+	/** 
+	 * Size in centimeters of the cells of the prop spatial hash grid.
+	 * Roughly the typical PhysicsCullDistance works well: fewer, bigger cells mean more props tested per observer.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Optimization", meta = (ClampMin = "100.0"))
+	float GridCellSize = 2500.0f;
+
+	/** Props falling below this height (cm) are considered out of the world and removed. Props with a PhysicsCullDistance of 0 are never removed by it. */
+	UPROPERTY(Config, EditAnywhere, Category = "Optimization")
+	float KillZ = -20000.0f; // -200 meters
+
+	// --- Welding ---
+
+	/** 
+	 * If true, groups of touching props that stayed asleep for WeldDelay are welded into a single compound rigid body
+	 * (visual meshes kept), so waking a stack costs one body instead of an island of contacts.
+	 * A hit, damage or explosion above WeldBreakVelocityChange splits the group back into individual props.
+	 * Runs on the server and in standalone only, clients receive the result through replication.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Welding")
+	bool bEnableWelding = false;
+
+	/** Time (s) a prop must have been asleep before it can be welded. */
+	UPROPERTY(Config, EditAnywhere, Category = "Welding", meta = (ClampMin = "0.0", EditCondition = "bEnableWelding"))
+	float WeldDelay = 3.0f;
+
+	/** Props whose bounds are closer than this (cm) are considered touching. */
+	UPROPERTY(Config, EditAnywhere, Category = "Welding", meta = (ClampMin = "0.0", EditCondition = "bEnableWelding"))
+	float WeldContactTolerance = 2.0f;
+
+	/** Maximum number of props in a weld group, larger stacks are split into several connected groups. */
+	UPROPERTY(Config, EditAnywhere, Category = "Welding", meta = (ClampMin = "2", EditCondition = "bEnableWelding"))
+	int32 MaxWeldGroupSize = 32;
+
+	/** Velocity change (cm/s) a hit, damage or explosion must give a welded prop to break its group. */
+	UPROPERTY(Config, EditAnywhere, Category = "Welding", meta = (ClampMin = "0.0", EditCondition = "bEnableWelding"))
+	float WeldBreakVelocityChange = 300.0f;
+
+	/** When a group breaks, only its props closer than this (cm) to the impact wake up, the others stay asleep. */
+	UPROPERTY(Config, EditAnywhere, Category = "Welding", meta = (ClampMin = "0.0", EditCondition = "bEnableWelding"))
+	float WeldBreakWakeRadius = 150.0f;
+
+	// --- Physics Thread ---
+
+	/** 
+	 * If true, CCD switching, the kinematic target of held props (Teleport grab mode) and damage impulses run in a
+	 * physics thread callback at every physics step, instead of on the game thread one frame late.
+	 * Meant for projects with async physics enabled (Project Settings -> Physics -> Tick Physics Async).
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics Thread")
+	bool bPhysicsThreadCallback = false;
+
+	// --- Registration ---
+
+	/** 
+	 * If true, props placed in a level don't physicalize in their BeginPlay: they are queued and physicalized
+	 * by the prop subsystem within RegistrationBudgetMs per frame, closest to an observer first.
+	 * Queued props stay kinematic until then. Props spawned at runtime always physicalize right away.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Registration")
+	bool bDeferredRegistration = true;
+
+	/** Game thread time (ms) spent physicalizing queued props each frame. At least one prop is processed per frame. */
+	UPROPERTY(Config, EditAnywhere, Category = "Registration", meta = (ClampMin = "0.0", EditCondition = "bDeferredRegistration"))
+	float RegistrationBudgetMs = 1.0f;
+
+	// --- Pooling ---
+
+	/** 
+	 * If true, props falling below KillZ or entering a kill volume are released to the prop pool of their class
+	 * (hidden, ready for UPhysicsPropSubsystem::AcquireProp) instead of being destroyed.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Pooling")
+	bool bRecycleOutOfWorldProps = true;
+
+	/** Maximum number of idle props kept per class. Props released to a full pool are destroyed. */
+	UPROPERTY(Config, EditAnywhere, Category = "Pooling", meta = (ClampMin = "0"))
+	int32 MaxPooledPropsPerClass = 64;
+
+	// --- Physics LOD ---
+	// Tier boundaries are multiples of each prop's PhysicsCullDistance.
+
+	/** 
+	 * Distance ratio past which a prop uses fewer solver iterations and more damping.
+	 * Equal to LODFrozenDistanceRatio (default), there is no Reduced tier: props simulate at full quality up to their
+	 * cull distance. Lower it (e.g. 0.5) to enable the tier.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0"))
+	float LODReducedDistanceRatio = 1.0f;
+
+	/** Distance ratio past which a prop stops simulating and stays frozen in place (kinematic). */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0"))
+	float LODFrozenDistanceRatio = 1.0f;
+
+	/** Distance ratio past which a prop's body is removed from the physics scene. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0"))
+	float LODDormantDistanceRatio = 2.0f;
+
+	/** 
+	 * If true, the LOD pass also uses what observers can see: props outside every player's view and not rendered
+	 * recently are demoted sooner (LODOffscreenDistanceScale), large props on screen stay Full (LODKeepFullScreenSize).
+	 * Interest sources have no view, props near them are treated as visible.
+	 * Off by default: unseen props settle into Frozen/Dormant closer to the player than with distance alone.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD")
+	bool bVisibilityAwareLOD = false;
+
+	/** Distance multiplier of props nobody sees: 2 = an unseen prop changes tier at half the distance. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "1.0", EditCondition = "bVisibilityAwareLOD"))
+	float LODOffscreenDistanceScale = 2.0f;
+
+	/** Props rendered on screen within this time (s) count as seen, even outside the view cones (e.g. other viewports, reflections). 0 = view cones only. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0", EditCondition = "bVisibilityAwareLOD"))
+	float LODRecentRenderTime = 0.5f;
+
+	/** 
+	 * Props in view whose bounds cover at least this fraction of the screen stay in the Full tier, whatever their
+	 * distance (up to the Dormant boundary). 0 = disabled.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0", EditCondition = "bVisibilityAwareLOD"))
+	float LODKeepFullScreenSize = 0.15f;
+
+	/** 
+	 * Width of the hysteresis band, as a fraction of a tier boundary.
+	 * 0.1 = a prop enters a tier at 100% of its boundary and leaves it at 90%.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0", ClampMax = "0.9"))
+	float LODHysteresis = 0.1f;
+
+	/** Time (s) a prop brought back to Full by damage, a grab or replication stays Full before the LOD pass may demote it. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0"))
+	float LODPromotionHoldTime = 3.0f;
+
+	/** Maximum number of props changing tier in a single frame. Remaining changes are spread over the next frames. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "1"))
+	int32 MaxLODTransitionsPerFrame = 32;
+
+	/** Position solver iterations used in the Reduced tier. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "1", ClampMax = "255"))
+	int32 ReducedPositionIterations = 2;
+
+	/** Velocity solver iterations used in the Reduced tier. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "1", ClampMax = "255"))
+	int32 ReducedVelocityIterations = 1;
+
+	/** Linear and angular damping used in the Reduced tier, to help props settle sooner. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0"))
+	float ReducedDamping = 1.0f;
+
+	/** 
+	 * If true, props in the Reduced and Frozen tiers collide with a single box or sphere around their authored
+	 * collision, shared by all the props of a mesh. Mass is kept, complex traces hit the simple shape too.
+	 * Shapes are swapped back and forth only on props asleep or slower than CollisionLODMaxSpeed, within the
+	 * LOD transition budget. Props with simple collision aren't welded.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD")
+	bool bEnableCollisionLOD = false;
+
+	/** Speed (cm/s) below which an awake prop may change collision shape. */
+	UPROPERTY(Config, EditAnywhere, Category = "Physics LOD", meta = (ClampMin = "0.0", EditCondition = "bEnableCollisionLOD"))
+	float CollisionLODMaxSpeed = 50.0f;
+
+	// --- Hibernation ---
+
+	/** If true, props dormant for long enough are hidden and drawn as instances of a shared instanced static mesh. */
+	UPROPERTY(Config, EditAnywhere, Category = "Hibernation")
+	bool bEnableHibernation = true;
+
+	/** Time in seconds a prop must stay in the Dormant tier before being hibernated. */
+	UPROPERTY(Config, EditAnywhere, Category = "Hibernation", meta = (ClampMin = "0.0", EditCondition = "bEnableHibernation"))
+	float HibernationDelay = 10.0f;
+
+	/** 
+	 * If true, the instances of hibernated props can be hit by queries (but never simulate).
+	 * Pass such hits to RehydratePropFromHit to bring the prop back.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Hibernation", meta = (EditCondition = "bEnableHibernation"))
+	bool bHibernatedProxyCollision = true;
+
+	// --- Damage ---
+
+	/** 
+	 * If true, props react to radial damage through their own OnTakeRadialDamage event.
+	 * Disable it when explosions push props with UPhysicsPropSubsystem::ApplyExplosion, to skip the per-actor dispatch.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Damage")
+	bool bBindRadialDamageEvents = true;
+
+	/** 
+	 * If true, the impulses of all damage events a prop receives during a frame are summed and applied
+	 * once at the end of the frame (one wake, one impulse per body), instead of one physics call per event.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Damage")
+	bool bCoalesceDamageImpulses = true;
+
+	/** Maximum number of sleeping, frozen or dormant props a single ApplyExplosion call may wake. Awake props are always pushed. */
+	UPROPERTY(Config, EditAnywhere, Category = "Damage", meta = (ClampMin = "0"))
+	int32 MaxPropsWokenPerExplosion = 64;
+
+	// --- Networking ---
+
+	/** 
+	 * If true, props don't replicate themselves: a single manager actor replicates the state of the awake props only,
+	 * and clients interpolate their local props toward it. Removes one actor channel per prop on the server.
+	 * Props are matched by path name, so only level-placed props use this mode. Props spawned at runtime
+	 * (pooled ones included) keep replicating as actors.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Networking")
+	bool bAggregatedReplication = false;
+
+	/** Speed at which clients move aggregated props toward their replicated state. */
+	UPROPERTY(Config, EditAnywhere, Category = "Networking", meta = (ClampMin = "0.0", EditCondition = "bAggregatedReplication"))
+	float NetInterpolationSpeed = 15.0f;
+
+	/** Error (cm) past which clients snap aggregated props to their replicated state instead of interpolating. */
+	UPROPERTY(Config, EditAnywhere, Category = "Networking", meta = (ClampMin = "0.0", EditCondition = "bAggregatedReplication"))
+	float NetSnapDistance = 200.0f;
+
+	/** Net update frequency (Hz) of awake props in the Full tier. Sleeping props are net dormant and never updated. */
+	UPROPERTY(Config, EditAnywhere, Category = "Networking", meta = (ClampMin = "1.0"))
+	float NetUpdateFrequencyFull = 30.0f;
+
+	/** Net update frequency (Hz) of awake props in the Reduced tier. Frozen and Dormant props are net dormant. */
+	UPROPERTY(Config, EditAnywhere, Category = "Networking", meta = (ClampMin = "1.0"))
+	float NetUpdateFrequencyReduced = 10.0f;
+
+	// --- Impact Audio ---
+
+	/** 
+	 * If true, props don't notify rigid body collisions and don't use OnComponentHit: the prop subsystem reads the
+	 * batch of contacts the Chaos solver records on the physics thread, once per physics frame, and only the contacts
+	 * passing the threshold, cooldown and rate limit of their prop turn into impacts.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio")
+	bool bBatchedImpactEvents = false;
+
+	/** 
+	 * Batched impact events only: contacts with a relative speed (cm/s) below this are dropped by the solver
+	 * on the physics thread, before being recorded (resting jitter, gentle rolling). 0 = no solver filter.
+	 * This is the solver's collision event filter: it applies to every hit event of the world, not only props.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0.0", EditCondition = "bBatchedImpactEvents"))
+	float ImpactEventMinSpeed = 0.0f;
+
+	/** Maximum number of impact sounds started in a single frame, all props included. */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0"))
+	int32 MaxImpactSoundsPerFrame = 8;
+
+	/** Maximum number of impact sounds started over any one second window, all props included. */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0"))
+	int32 MaxImpactSoundsPerSecond = 40;
+
+	/** Hits of the same sound closer than this distance (cm) are merged into a single event. */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0.0"))
+	float ImpactCoalesceRadius = 150.0f;
+
+	/** Hits of the same sound happening within this time (s) after a played one, nearby, are merged into it. */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0.0"))
+	float ImpactCoalesceTime = 0.1f;
+
+	/** Volume gained by a merged event for every extra hit it contains (0.15 = +15% per hit). */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0.0"))
+	float ImpactCoalesceVolumeBoost = 0.15f;
+
+	/** Volume cap of merged events. */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0.0"))
+	float MaxCoalescedVolume = 1.5f;
+
+	/** Distance (cm) at which an impact's priority is halved when ranking against the voice budget. */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "1.0"))
+	float ImpactListenerFalloffDistance = 1500.0f;
+
+	/** 
+	 * Props closer than this (cm) to an observer keep the impact sounds of their surface loaded.
+	 * Only props within their Dormant distance are considered, a larger range has no effect on them.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0.0"))
+	float ImpactSoundBankRange = 3000.0f;
+
+	/** Time (s) a sound bank stays loaded after the last prop needing it left the range. */
+	UPROPERTY(Config, EditAnywhere, Category = "Audio", meta = (ClampMin = "0.0"))
+	float ImpactSoundBankReleaseDelay = 10.0f;
+
+	// --- Impact VFX ---
+
+	/** Maximum number of impact particle systems started in a single frame, all props included. */
+	UPROPERTY(Config, EditAnywhere, Category = "VFX", meta = (ClampMin = "0"))
+	int32 MaxImpactVFXPerFrame = 4;
+
+	/** Maximum number of impact decals placed in a single frame, all props included. */
+	UPROPERTY(Config, EditAnywhere, Category = "VFX", meta = (ClampMin = "0"))
+	int32 MaxImpactDecalsPerFrame = 2;
+
+	/** Niagara components reused for impacts. When all are busy, the oldest effect is restarted elsewhere. */
+	UPROPERTY(Config, EditAnywhere, Category = "VFX", meta = (ClampMin = "1"))
+	int32 ImpactVFXPoolSize = 24;
+
+	/** Decal components reused for impacts. When all are shown, the oldest decal is moved. */
+	UPROPERTY(Config, EditAnywhere, Category = "VFX", meta = (ClampMin = "1"))
+	int32 ImpactDecalPoolSize = 48;
+
+	/** Impacts farther than this (cm) from every local player's view point spawn no particles nor decal. */
+	UPROPERTY(Config, EditAnywhere, Category = "VFX", meta = (ClampMin = "0.0"))
+	float ImpactVFXCullDistance = 4000.0f;
+};
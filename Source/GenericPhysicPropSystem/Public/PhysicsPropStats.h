@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// Profiling hooks of the prop system:
+// - "stat PhysicsProps" in game for the cycle and counter stats below,
+// - the PhysicsProps category of the CSV profiler ("-csvCategories=PhysicsProps" or "csvprofile start"),
+// - the PhysicsProps channel of Unreal Insights ("-trace=cpu,PhysicsProps") for wake and sleep transitions,
+// - FPhysicsPropTimings, per-function game thread time read by the automated benchmarks.
+
+DECLARE_STATS_GROUP(TEXT("Physics Props"), STATGROUP_PhysicsProps, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Awake Props"), STAT_PhysicsProps_NumAwake, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Asleep Props"), STAT_PhysicsProps_NumAsleep, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Culled Props (Frozen/Dormant)"), STAT_PhysicsProps_NumCulled, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CCD Toggles"), STAT_PhysicsProps_CCDToggles, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Impact Sounds Played"), STAT_PhysicsProps_ImpactSoundsPlayed, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Impact Sounds Rejected"), STAT_PhysicsProps_ImpactSoundsRejected, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Impact VFX Spawned"), STAT_PhysicsProps_ImpactVFXSpawned, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Impact VFX Rejected"), STAT_PhysicsProps_ImpactVFXRejected, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Impact Sound Banks"), STAT_PhysicsProps_NumSoundBanks, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Welded Props"), STAT_PhysicsProps_NumWelded, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Simple Collision Props"), STAT_PhysicsProps_NumSimpleCollision, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pending Registrations"), STAT_PhysicsProps_NumPendingRegistrations, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Grab Sweeps"), STAT_PhysicsProps_GrabSweeps, STATGROUP_PhysicsProps, GENERICPHYSICPROPSYSTEM_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GENERICPHYSICPROPSYSTEM_API, PhysicsProps);
+
+UE_TRACE_CHANNEL_EXTERN(PhysicsPropsChannel, GENERICPHYSICPROPSYSTEM_API);
+
+/** Prop system functions timed by FPhysicsPropTimings. */
+enum class EPhysicsPropTiming : uint8
+{
+	SubsystemTick,
+	CCDPass,
+	LODPass,
+	LODTransitions,
+	WeldPass,
+	ApplyExplosion,
+	NetReplication,
+	NetInterpolation,
+	Registration,
+	ComponentTick,
+	UpdateGrabbedPosition,
+	ComponentHit,
+	CollisionEvents,
+	Damage,
+	FlushDamage,
+	Num
+};
+
+#ifndef PHYSICSPROP_WITH_TIMINGS
+#define PHYSICSPROP_WITH_TIMINGS WITH_DEV_AUTOMATION_TESTS
+#endif
+
+#if PHYSICSPROP_WITH_TIMINGS
+
+/** Game thread time spent in each timed function while enabled (inclusive), for the automated benchmarks. */
+struct GENERICPHYSICPROPSYSTEM_API FPhysicsPropTimings
+{
+	static bool bEnabled;
+	static double Seconds[(int32)EPhysicsPropTiming::Num];
+	static int32 Calls[(int32)EPhysicsPropTiming::Num];
+
+	static void Reset();
+	static const TCHAR* GetName(EPhysicsPropTiming Timing);
+};
+
+struct FPhysicsPropTimingScope
+{
+	explicit FPhysicsPropTimingScope(EPhysicsPropTiming InTiming)
+		: Timing(InTiming)
+		, StartTime(FPhysicsPropTimings::bEnabled ? FPlatformTime::Seconds() : 0.0)
+	{
+	}
+
+	~FPhysicsPropTimingScope()
+	{
+		if (StartTime > 0.0)
+		{
+			FPhysicsPropTimings::Seconds[(int32)Timing] += FPlatformTime::Seconds() - StartTime;
+			++FPhysicsPropTimings::Calls[(int32)Timing];
+		}
+	}
+
+	EPhysicsPropTiming Timing;
+	double StartTime;
+};
+
+#define PHYSICSPROP_TIMING_SCOPE(Timing) FPhysicsPropTimingScope PhysicsPropTimingScope(EPhysicsPropTiming::Timing)
+
+#else
+
+#define PHYSICSPROP_TIMING_SCOPE(Timing)
+
+#endif
@@ -0,0 +1,510 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "PropSpatialHashGrid.h"
+#include "PropImpactAudioScheduler.h"
+#include "PropImpactVFXSpawner.h"
+#include "PropImpactSoundBanks.h"
+#include "PhysicsPropDamageType.h"
+#include "PropNetState.h"
+#include "PropStateSnapshot.h"
+#include "PropPhysicsCallback.h"
+#include "PhysicsPropSubsystem.generated.h"
+
+class UPhysicsPropComponent;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+class UBodySetup;
+class UDamageType;
+class APropReplicationManager;
+class ULevel;
+
+namespace Chaos
+{
+	struct FCollisionEventData;
+}
+
+/** Hibernated props sharing the same static mesh, drawn by a single instanced component. */
+USTRUCT()
+struct FPropProxyBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Instances = nullptr;
+
+	/** Prop of each instance, same order as the instances. Both are swap-removed. */
+	UPROPERTY()
+	TArray<UPhysicsPropComponent*> Props;
+};
+
+/** Idle props of one class, waiting to be acquired. */
+USTRUCT()
+struct FPropPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> Available;
+};
+
+/**
+ * Central manager for every UPhysicsPropComponent of a world.
+ * Props register themselves when physicalized. Their state is kept in packed
+ * arrays (one array per field) so that per-frame and per-interval work runs as
+ * a single batch instead of thousands of individual timers and ticks.
+ * Props are also stored in a spatial hash grid: culling only visits the cells
+ * around the observers (every player view point plus registered interest sources).
+ * Props dormant for long enough are hibernated: hidden and drawn as an instance of a
+ * shared instanced static mesh, until an observer, damage or a query brings them back.
+ */
+UCLASS()
+class GENERICPHYSICPROPSYSTEM_API UPhysicsPropSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UWorldSubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	/** Adds a prop to the managed set. Does nothing if it is already registered. */
+	void RegisterProp(UPhysicsPropComponent* Prop);
+
+	/** 
+	 * Queues a level prop whose BeginPlay deferred its Physicalize (bDeferredRegistration).
+	 * Queued props are physicalized within RegistrationBudgetMs per frame, closest to an observer first.
+	 */
+	void QueueRegistration(UPhysicsPropComponent* Prop);
+
+	/** Takes a prop out of the registration queue, e.g. when it leaves play or gets physicalized early. */
+	void DequeueRegistration(UPhysicsPropComponent* Prop);
+
+	/** Number of props waiting in the registration queue, entries of dequeued props included until the queue reaches them. */
+	int32 GetNumPendingRegistrations() const { return PendingRegistrations.Num() - NextRegistration; }
+
+	/** Removes a prop from the managed set. */
+	void UnregisterProp(UPhysicsPropComponent* Prop);
+
+	/** Notifies the subsystem that a prop started or stopped moving. */
+	void SetPropAwake(UPhysicsPropComponent* Prop, bool bAwake);
+
+	/** Notifies the subsystem that a prop changed its physics LOD on its own (e.g. woken up by damage). */
+	void NotifyPropLODChanged(UPhysicsPropComponent* Prop);
+
+	/** Number of props currently registered. */
+	int32 GetNumProps() const { return Props.Num(); }
+
+	/** 
+	 * Adds an actor that keeps nearby props simulated, like a player would (e.g. AI, cinematic camera).
+	 * Player view points are always used as observers and don't need to be registered.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Optimization")
+	void RegisterInterestSource(AActor* Source);
+
+	/** Removes an actor previously added with RegisterInterestSource. */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Optimization")
+	void UnregisterInterestSource(AActor* Source);
+
+	/** 
+	 * Brings back every hibernated prop within a radius, fully simulated.
+	 * Call it for gameplay events that should affect far away props (e.g. an explosion).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Optimization")
+	void RehydratePropsInRadius(FVector Origin, float Radius);
+
+	/** 
+	 * Brings back the hibernated prop a trace or sweep hit, fully simulated.
+	 * @return The actor of the prop, or nullptr if the hit wasn't on a hibernated prop.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Optimization")
+	AActor* RehydratePropFromHit(const FHitResult& Hit);
+
+	/** 
+	 * Pushes every prop within a radius in a single batch, instead of per-actor radial damage events.
+	 * Frozen, dormant and hibernated props in range are brought back to full simulation first.
+	 * Gameplay damage is not applied, only the physics reaction.
+	 * @param Origin Center of the explosion.
+	 * @param Radius Radius of the explosion (cm).
+	 * @param Damage Damage at the center, converted to an impulse by the damage type (like OnTakeRadialDamage).
+	 * @param DamageTypeClass Damage type resolving the impulse multiplier (UPhysicsPropDamageType, UGenericDamageType...).
+	 * @param Falloff How the impulse decreases with the distance to the origin.
+	 * @return Number of props pushed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Damage")
+	int32 ApplyExplosion(FVector Origin, float Radius, float Damage, TSubclassOf<UDamageType> DamageTypeClass, ERadialImpulseFalloff Falloff = RIF_Linear);
+
+	/** 
+	 * Returns a prop actor of a class at a location, taken from the pool when one is idle, spawned otherwise.
+	 * Pooled props come back simulated, at rest, with no grab or damage state.
+	 * @param PropClass Class of the prop actor. Must have a UPhysicsPropComponent.
+	 * @param Transform Where the prop appears.
+	 * @param Mesh Optional mesh to use. A pooled prop already using it is preferred, others get their mesh swapped.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Pooling", meta = (AdvancedDisplay = "Mesh"))
+	AActor* AcquireProp(TSubclassOf<AActor> PropClass, FTransform Transform, UStaticMesh* Mesh = nullptr);
+
+	/** 
+	 * Hides a prop and keeps it for a later AcquireProp instead of destroying it.
+	 * The prop is destroyed if the pool of its class is full (MaxPooledPropsPerClass).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Pooling")
+	void ReleaseProp(AActor* PropActor);
+
+	/** Spawns props of a class straight into the pool, e.g. during a loading screen. */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Pooling")
+	void PrewarmPool(TSubclassOf<AActor> PropClass, int32 Count);
+
+	/** Adds a box in which props are considered out of the world, like below KillZ. */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Pooling")
+	void AddKillVolume(FBox Volume);
+
+	/** Removes every box added with AddKillVolume. */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Pooling")
+	void ClearKillVolumes();
+
+	/** 
+	 * Writes the state of every registered prop (pooled ones excluded) as a binary snapshot, in a single pass
+	 * over the prop buffers. Restore it with RestoreAllPropStates, e.g. from a save game or a checkpoint.
+	 * Props are identified by their actor's path name, so spawned props only restore within the same session.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Snapshots")
+	void SaveAllPropStates(TArray<uint8>& OutData) const;
+
+	/** 
+	 * Puts every prop of a snapshot made by SaveAllPropStates back in its saved state, reading the data in a single pass.
+	 * Props at rest in the snapshot start asleep. Props missing from the world are skipped.
+	 * @return Number of props restored, 0 if the data isn't a valid snapshot.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Jam Physics|Snapshots")
+	int32 RestoreAllPropStates(const TArray<uint8>& Data);
+
+	/** Captures the state of the registered props, only the ones of a level if one is given. */
+	void CapturePropStates(FPropStateSnapshot& OutSnapshot, const ULevel* Level = nullptr) const;
+
+	/** 
+	 * Applies baked rest states (see APropRestSnapshot). Props not registered yet, e.g. beginning play
+	 * after the snapshot or waiting for a deferred registration, get their state when they register.
+	 * States still unused once the registration queue is empty are dropped.
+	 */
+	void AddBakedPropStates(const FPropStateSnapshot& Snapshot);
+
+	/** Number of registered props currently awake. */
+	int32 GetNumAwakeProps() const;
+
+	/** 
+	 * Splits the weld group of a prop if an impulse giving it this velocity change is above WeldBreakVelocityChange.
+	 * Only the props of the group within WeldBreakWakeRadius of Location wake up.
+	 * @return True if the group was split.
+	 */
+	bool BreakWeldOnImpulse(UPhysicsPropComponent* Prop, const FVector& Location, float VelocityChange);
+
+	/** Splits the weld group of a prop, keeping the group asleep or awake (e.g. before a grab or a LOD change). */
+	void DissolveWeldGroup(UPhysicsPropComponent* Prop);
+
+	/** First prop of the weld group of a prop, owning the compound body. The prop itself if not welded. */
+	UPhysicsPropComponent* GetWeldRoot(UPhysicsPropComponent* Prop) const;
+
+	/** Number of props currently welded in a group. */
+	int32 GetNumWeldedProps() const { return NumWeldedProps; }
+
+	/** Replaces a dormant prop by an instance of the shared mesh of its batch. */
+	void HibernateProp(UPhysicsPropComponent* Prop);
+
+	/** Removes the proxy instance of a hibernated prop and shows the prop again. It stays dormant. */
+	void RehydrateProp(UPhysicsPropComponent* Prop);
+
+	/** Returns the impulse multipliers of a damage type, resolved once per damage class. */
+	const FPropDamageResponse& GetDamageResponse(const UDamageType* DamageType);
+
+	/** Schedules the flush of the damage impulses a prop accumulated this frame. */
+	void QueueDamageFlush(UPhysicsPropComponent* Prop);
+
+	/** Client: state of an aggregated prop received from the replication manager. */
+	void ReceiveNetPropState(uint32 PropId, const FPropNetState& State);
+
+	/** Physics thread callback of the prop system, null unless bPhysicsThreadCallback is set. */
+	FPropPhysicsCallback* GetPhysicsCallback() const { return PhysicsCallback; }
+
+	/** Global impact sound scheduler, flushed once per frame by the subsystem tick. */
+	FPropImpactAudioScheduler& GetImpactAudio() { return ImpactAudio; }
+
+	/** Global impact particle and decal spawner, flushed once per frame by the subsystem tick. */
+	FPropImpactVFXSpawner& GetImpactVFX() { return ImpactVFX; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Bit flags stored per prop in StateFlags. */
+	enum EPropStateFlags : uint8
+	{
+		PSF_None        = 0,
+		PSF_Awake       = 1 << 0,
+		PSF_CCD         = 1 << 1,
+		PSF_SimpleCollision = 1 << 2,
+	};
+
+	/** Batched impact events: turns the contacts recorded by the solver during a physics frame into prop impacts. */
+	void HandleCollisionEvents(const Chaos::FCollisionEventData& CollisionData);
+
+	/** Reads the results of the physics steps completed since the last frame. */
+	void ReadPhysicsCallbackOutputs();
+
+	/** Requires the impact sound banks of the props in range, from the distances of the LOD pass. */
+	void UpdateImpactSoundBanks();
+
+	/** Recomputes MaxCullDistance from the registered props. */
+	void RefreshMaxCullDistance();
+
+	/** Shared box or sphere collision of a mesh, null if its authored collision is already that simple. */
+	UBodySetup* GetSimpleCollisionSetup(UStaticMesh* Mesh);
+
+	/** Queues the props whose collision shape should follow their tier, from the LOD pass. */
+	void QueueCollisionSwaps();
+
+	/** Physicalizes queued props until the registration budget of the frame is spent. */
+	void ProcessPendingRegistrations();
+
+	/** Copies the location of moving props into the position buffers and the grid. */
+	void GatherPositions();
+
+	/** Same as GatherPositions without the out of world checks, skipped if positions were already gathered this frame. */
+	void RefreshAwakePositions();
+
+	/** Collects the view point of every player and the location of every interest source. */
+	void GatherObservers();
+
+	/** Measures the distance of every prop to its closest observer and picks its physics LOD tier. */
+	void RunLODPass();
+
+	/** Applies pending LOD tier changes, within the per-frame transition budget. */
+	void ApplyLODTransitions();
+
+	/** Welds the groups of touching props that stayed asleep for WeldDelay. */
+	void RunWeldPass();
+
+	/** Welds props into a single compound body, the one of the first prop. */
+	void WeldProps(const TArray<UPhysicsPropComponent*>& Members);
+
+	/** Gives every prop of a group its own body back. Props within WakeRadius of Location wake up, the others keep the group's state. */
+	void BreakWeldGroup(int32 GroupIndex, const FVector& Location, float WakeRadius);
+
+	/** Thresholds the speed of every awake prop and toggles CCD on the ones that changed. */
+	void RunCCDPass();
+
+	/** Returns the instanced component drawing the hibernated props of a mesh, creating it if needed. */
+	FPropProxyBatch& GetOrCreateProxyBatch(UStaticMesh* Mesh, const UPhysicsPropComponent* Prop);
+
+	/** Writes a new location for a prop slot into the buffers and the grid, and refreshes its bounds radius. */
+	void SetPropLocation(int32 Index, const FVector& Location);
+
+	/** Publishes the prop counts to the stats system and the CSV profiler. */
+	void UpdateStatCounters() const;
+
+	/** Reads the state of a registered prop from the buffers. */
+	FPropStateRecord CapturePropState(int32 Index) const;
+
+	/** Moves a prop to a snapshot state, bringing it out of hibernation or a grab first. */
+	void ApplyPropState(UPhysicsPropComponent* Prop, const FPropStateRecord& Record);
+
+	/** Registered props by stable ID, pooled props and colliding IDs excluded. */
+	TMap<uint32, UPhysicsPropComponent*> MakePropsByStableId() const;
+
+	/** True if the prop is registered, not pooled, and the only one with its stable ID. */
+	bool HasUniqueStableId(const UPhysicsPropComponent* Prop) const;
+
+	/** Leaves a prop whose stable ID collides out of aggregated replication, its actor replicates again. */
+	void ExcludeStableId(UPhysicsPropComponent* Prop);
+
+	/** Server: sends the state of awake props through the replication manager, at their LOD update rate. */
+	void ReplicateAwakeProps();
+
+	/** Client: moves aggregated props toward their last replicated state. */
+	void InterpolateNetProps(float DeltaTime);
+
+	// --- Packed per-prop state. All arrays share the same index (UPhysicsPropComponent::PropIndex). ---
+
+	UPROPERTY()
+	TArray<UPhysicsPropComponent*> Props;
+
+	TArray<float> PosX;
+	TArray<float> PosY;
+	TArray<float> PosZ;
+
+	/** Squared cull distance, FLT_MAX when culling is disabled for the prop. */
+	TArray<float> CullDistSq;
+
+	/** Squared CCDSpeedThreshold, FLT_MAX when CCD switching is disabled for the prop. */
+	TArray<float> CCDThresholdSq;
+
+	TArray<uint8> StateFlags;
+
+	/** Grid cell the prop is currently stored in. */
+	TArray<FIntVector> GridCells;
+
+	/** Squared distance to the closest observer, FLT_MAX if no observer is within range. */
+	TArray<float> NearestDistSq;
+
+	/** Bounds radius of the mesh, for the view and screen size tests of the LOD pass. */
+	TArray<float> BoundsRadius;
+
+	// LOD pass scratch: largest screen size in any view (-1 = in no view) and distance used to pick the tier
+	TArray<float> LODScreenSizes;
+	TArray<float> LODDistSq;
+
+	/** Current EPropPhysicsLOD of the prop. */
+	TArray<uint8> LODTiers;
+
+	/** EPropPhysicsLOD picked by the last LOD pass. */
+	TArray<uint8> DesiredLODTiers;
+
+	// --- CCD pass scratch buffers, compacted to the awake props and padded to the SIMD width. ---
+
+	TArray<int32> CCDIndices;
+	TArray<float> CCDVelX;
+	TArray<float> CCDVelY;
+	TArray<float> CCDVelZ;
+	TArray<float> CCDThresholds;
+
+	/** One bit per lane, 4 lanes per entry. */
+	TArray<uint8> CCDMasks;
+
+	FPropSpatialHashGrid Grid;
+
+	FPropImpactAudioScheduler ImpactAudio;
+
+	FPropImpactVFXSpawner ImpactVFX;
+
+	/** Impact sounds of the props near observers, refreshed by the LOD pass. */
+	FPropImpactSoundBanks ImpactSoundBanks;
+
+	/** Largest finite cull distance of all registered props, scales the grid query radius. */
+	float MaxCullDistance = 0.0f;
+
+	/** A prop at MaxCullDistance left, the LOD pass recomputes it. */
+	bool bMaxCullDistanceDirty = false;
+
+	/** Props with damage impulses to apply at the end of the frame. */
+	TArray<TWeakObjectPtr<UPhysicsPropComponent>> PendingDamageFlushes;
+
+	/** Damage responses per damage class, null key for events without damage type. */
+	TMap<TObjectKey<UClass>, FPropDamageResponse> DamageResponses;
+
+	/** Actor owning the instanced components of hibernated props. */
+	UPROPERTY()
+	AActor* ProxyActor = nullptr;
+
+	UPROPERTY()
+	TMap<UStaticMesh*, FPropProxyBatch> ProxyBatches;
+
+	/** Dormant props that stayed dormant long enough, waiting for hibernation. */
+	TArray<TWeakObjectPtr<UPhysicsPropComponent>> PendingHibernations;
+
+	/** Simple collision shared by the props of each mesh, see bEnableCollisionLOD. */
+	UPROPERTY()
+	TMap<UStaticMesh*, UBodySetup*> SimpleCollisionSetups;
+
+	/** Props waiting to change collision shape. */
+	TArray<TWeakObjectPtr<UPhysicsPropComponent>> PendingCollisionSwaps;
+
+	/** Props waiting to be physicalized, closest to an observer first once sorted. */
+	TArray<TWeakObjectPtr<UPhysicsPropComponent>> PendingRegistrations;
+	int32 NextRegistration = 0;
+
+	/** Props were queued since the last sort of PendingRegistrations. */
+	bool bSortRegistrations = false;
+
+	/** Props waiting for a LOD tier change, most urgent first. */
+	TArray<TWeakObjectPtr<UPhysicsPropComponent>> PendingLODTransitions;
+	int32 NextLODTransition = 0;
+
+	TArray<TWeakObjectPtr<AActor>> InterestSources;
+
+	/** Observer locations of the current LOD pass. */
+	TArray<FVector> Observers;
+
+	/** View cone of an observer, same index as Observers. */
+	struct FPropObserverView
+	{
+		FVector Forward = FVector::ForwardVector;
+		float CosHalfFOV = -1.0f;
+		float TanHalfFOV = 1.0f;
+
+		/** False for interest sources, which see everything around them. */
+		bool bHasView = false;
+	};
+	TArray<FPropObserverView> ObserverViews;
+
+	/** Props found below KillZ or in a kill volume while gathering positions. */
+	TArray<TWeakObjectPtr<AActor>> OutOfWorldActors;
+
+	TArray<FBox> KillVolumes;
+
+	/** Baked rest states of props not registered yet, by stable ID. Dropped once the registration queue is empty. */
+	TMap<uint32, FPropStateRecord> PendingBakedStates;
+
+	/** Registered props by stable ID, colliding IDs excluded. */
+	TMap<uint32, UPhysicsPropComponent*> PropsByStableId;
+
+	/** Stable IDs shared by several props, none of them is saved, restored or aggregated. */
+	TSet<uint32> CollidingStableIds;
+
+	/** Idle props per actor class. */
+	UPROPERTY()
+	TMap<UClass*, FPropPool> Pools;
+
+	float TimeUntilNextCull = 0.0f;
+
+	/** Frame at which the positions of awake props were last copied into the buffers. */
+	uint64 AwakePositionsFrame = 0;
+
+	/** Props sharing one compound body, welded on the body of Members[0]. */
+	struct FPropWeldGroup
+	{
+		TArray<UPhysicsPropComponent*> Members;
+	};
+
+	/** Weld groups, indexed by UPhysicsPropComponent::WeldGroup. Members are registered props, kept alive by Props. */
+	TSparseArray<FPropWeldGroup> WeldGroups;
+	int32 NumWeldedProps = 0;
+
+	// --- Aggregated replication ---
+
+	/** Server only, replicates the awake props when bAggregatedReplication is set. */
+	UPROPERTY()
+	APropReplicationManager* ReplicationManager = nullptr;
+
+	/** Registered props by managed mesh, to resolve the contacts of batched impact events. */
+	TMap<const UPrimitiveComponent*, UPhysicsPropComponent*> PropsByMesh;
+
+	/** Runs CCD switching, held targets and damage impulses on the physics thread. Owned by the solver. */
+	FPropPhysicsCallback* PhysicsCallback = nullptr;
+
+	/** True while HandleCollisionEvents is registered with the solver's event manager. */
+	bool bCollisionEventsRegistered = false;
+
+	/** Registered props by stable network ID, aggregated replication only. */
+	TMap<uint32, UPhysicsPropComponent*> PropsByNetId;
+
+	/** Last replicated state of a prop, with the time it was received. */
+	struct FPropNetTarget
+	{
+		FPropNetState State;
+		FQuat Rotation;
+		float ReceiveTime;
+	};
+
+	/** Client only: props being moved toward their replicated state. */
+	TMap<uint32, FPropNetTarget> NetTargets;
+};
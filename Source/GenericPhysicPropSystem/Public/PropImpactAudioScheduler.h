@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USoundBase;
+class UWorld;
+
+/** An impact sound waiting to be played at the end of the frame. */
+struct FPropImpactSoundRequest
+{
+	USoundBase* Sound = nullptr;
+	FVector Location = FVector::ZeroVector;
+
+	/** Volume computed by the prop from its impact intensity. */
+	float Volume = 1.0f;
+
+	/** Number of hits merged into this request. */
+	int32 HitCount = 1;
+};
+
+/**
+ * Global scheduler for prop impact sounds.
+ * Hits are queued during the frame and flushed once: hits of the same sound close in
+ * space and time are merged into a single louder event, the remaining events are ranked
+ * by volume and listener distance, and only the best ones within the per-frame and
+ * per-second voice budgets are played.
+ */
+class GENERICPHYSICPROPSYSTEM_API FPropImpactAudioScheduler
+{
+public:
+	/** Adds a hit to the current frame. Hits close to an already queued one are merged. */
+	void QueueImpact(USoundBase* Sound, const FVector& Location, float Volume);
+
+	/** Plays the best queued events within budget and clears the queue. */
+	void Flush(UWorld* World);
+
+	void Reset();
+
+	/** Number of hits that were queued and didn't produce a sound (merged or over budget) since the last Reset. */
+	int32 GetNumRejected() const { return NumRejected; }
+
+	/** Number of sounds played since the last Reset. */
+	int32 GetNumPlayed() const { return NumPlayed; }
+
+private:
+	/** A sound played recently, used to merge hits happening right after it. */
+	struct FRecentImpact
+	{
+		/** Only compared, never dereferenced. */
+		const USoundBase* Sound;
+		FVector Location;
+		float Time;
+	};
+
+	/** Returns true if a matching sound was played within the coalescing window. */
+	bool IsCoveredByRecentImpact(const USoundBase* Sound, const FVector& Location, float CurrentTime, float RadiusSq) const;
+
+	TArray<FPropImpactSoundRequest> PendingRequests;
+	TArray<FRecentImpact> RecentImpacts;
+
+	/** Time at which each sound of the last second was played, oldest first. */
+	TArray<float> PlayTimes;
+
+	/** Per-request ranking score of the current flush. */
+	TArray<float> Scores;
+
+	int32 NumRejected = 0;
+	int32 NumPlayed = 0;
+};
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "Chaos/ChaosEngineInterface.h"
+
+class UPropPhysicsImpactData;
+struct FStreamableHandle;
+
+/**
+ * Streams the impact sounds of the props near observers.
+ * A bank is the set of sounds a prop of one surface type can play with one impact table. The prop subsystem
+ * requires the banks of the props in range on every LOD pass. Banks are loaded asynchronously through the
+ * streamable manager and released once nothing required them for the release delay.
+ */
+class GENERICPHYSICPROPSYSTEM_API FPropImpactSoundBanks
+{
+public:
+	/** Marks the bank of a prop surface as needed by the current pass. */
+	void RequireBank(UPropPhysicsImpactData* Table, EPhysicalSurface PropSurface);
+
+	/** Starts loading the newly required banks and releases the ones unused for too long. */
+	void Update(float CurrentTime);
+
+	/** Releases every bank. */
+	void Reset();
+
+	/** Number of banks currently held (loaded or loading). */
+	int32 GetNumBanks() const { return Banks.Num(); }
+
+private:
+	struct FBank
+	{
+		TWeakObjectPtr<UPropPhysicsImpactData> Table;
+		TSharedPtr<FStreamableHandle> Handle;
+		float LastRequiredTime = 0.0f;
+		bool bRequired = false;
+	};
+
+	/** Banks by impact table and prop surface. */
+	TMap<TPair<TObjectKey<UPropPhysicsImpactData>, uint8>, FBank> Banks;
+};
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FImpactSoundEntry;
+class UNiagaraSystem;
+class UNiagaraComponent;
+class UMaterialInterface;
+class UDecalComponent;
+class UWorld;
+
+/** Particles and decal of an impact waiting to be spawned at the end of the frame. */
+struct FPropImpactVFXRequest
+{
+	UNiagaraSystem* System = nullptr;
+	float Scale = 1.0f;
+
+	UMaterialInterface* Decal = nullptr;
+	FVector DecalSize = FVector::ZeroVector;
+	float DecalLifetime = 0.0f;
+
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+
+	/** Impact strength (0.2 - 1) computed by the prop from its impact intensity. */
+	float Strength = 1.0f;
+};
+
+/**
+ * Global spawner for prop impact particles and decals.
+ * Hits are queued during the frame and flushed once: hits of the same effect close to each other are merged,
+ * the ones too far from every local view are dropped, and the closest ones within the per-frame budgets are
+ * spawned on Niagara and decal components reused from fixed size pools.
+ */
+class GENERICPHYSICPROPSYSTEM_API FPropImpactVFXSpawner
+{
+public:
+	/** Adds the effects of an impact entry to the current frame. */
+	void QueueImpact(const FImpactSoundEntry& Entry, const FVector& Location, const FVector& Normal, float Strength);
+
+	/** Spawns the closest queued effects within budget and clears the queue. */
+	void Flush(UWorld* World);
+
+	/** Clears the queue and destroys the pooled components. */
+	void Reset();
+
+	/** The pooled components only live through this, the owning subsystem must forward its collector here. */
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+	/** Number of effects (particles or decals) spawned since the last Reset. */
+	int32 GetNumSpawned() const { return NumSpawned; }
+
+	/** Number of queued hits that spawned nothing (merged, culled or over budget) since the last Reset. */
+	int32 GetNumRejected() const { return NumRejected; }
+
+private:
+	/** Returns an idle pooled component, a new one while the pool isn't full, or else the oldest one. */
+	UNiagaraComponent* AcquireVFXComponent(UWorld* World);
+	UDecalComponent* AcquireDecalComponent(UWorld* World);
+
+	/** Hides the decals whose lifetime is over. */
+	void ReleaseExpiredDecals(float CurrentTime);
+
+	TArray<FPropImpactVFXRequest> PendingRequests;
+
+	/** Distance of each request to the closest view of the current flush. */
+	TArray<float> DistancesSq;
+
+	TArray<TObjectPtr<UNiagaraComponent>> VFXPool;
+	int32 NextVFX = 0;
+
+	TArray<TObjectPtr<UDecalComponent>> DecalPool;
+
+	/** Time at which each pooled decal goes back to the pool, 0 if already hidden. */
+	TArray<float> DecalExpireTimes;
+	int32 NextDecal = 0;
+
+	int32 NumSpawned = 0;
+	int32 NumRejected = 0;
+};
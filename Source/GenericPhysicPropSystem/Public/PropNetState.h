@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PropNetState.generated.h"
+
+/**
+ * Quantized physics state of an awake prop, replicated instead of FRepMovement.
+ * Position is sent at 1mm, velocities at 1cm/s (1deg/s), rotation as a 32 bit smallest-three quaternion,
+ * and velocities are skipped entirely once the prop is at rest.
+ * Values are quantized when captured, so sub-precision jitter never counts as a change to replicate.
+ */
+USTRUCT()
+struct GENERICPHYSICPROPSYSTEM_API FPropNetState
+{
+	GENERATED_BODY()
+
+	FVector Location = FVector::ZeroVector;
+
+	/** Rotation packed by PackRotation. */
+	uint32 PackedRotation = 0;
+
+	FVector LinearVelocity = FVector::ZeroVector;
+
+	/** Degrees per second. */
+	FVector AngularVelocity = FVector::ZeroVector;
+
+	bool bAwake = false;
+
+	/** Stores a quantized copy of a body's state. */
+	void Capture(const FTransform& Transform, const FVector& InLinearVelocity, const FVector& InAngularVelocity, bool bInAwake);
+
+	FQuat GetRotation() const { return UnpackRotation(PackedRotation); }
+
+	/** 2 bits for the largest component, 10 bits for each of the three others (q and -q being the same rotation). */
+	static uint32 PackRotation(const FQuat& Rotation);
+	static FQuat UnpackRotation(uint32 Packed);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FPropNetState& Other) const
+	{
+		return bAwake == Other.bAwake
+			&& PackedRotation == Other.PackedRotation
+			&& Location == Other.Location
+			&& LinearVelocity == Other.LinearVelocity
+			&& AngularVelocity == Other.AngularVelocity;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FPropNetState> : public TStructOpsTypeTraitsBase2<FPropNetState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chaos/SimCallbackObject.h"
+#include "Chaos/SimCallbackInput.h"
+
+class FSingleParticlePhysicsProxy;
+
+/** CCD threshold of a body, or its removal when ThresholdSq is 0. */
+struct FPropCCDBody
+{
+	/** Unique index of the body's particle. */
+	int32 ParticleId = INDEX_NONE;
+	float ThresholdSq = 0.0f;
+};
+
+/** Kinematic target of a held body. */
+struct FPropKinematicTarget
+{
+	FSingleParticlePhysicsProxy* Proxy = nullptr;
+	FTransform Transform;
+};
+
+/** Damage impulses of a body accumulated during a game frame. */
+struct FPropImpulseCommand
+{
+	FSingleParticlePhysicsProxy* Proxy = nullptr;
+	FVector VelocityChange = FVector::ZeroVector;
+	FVector Impulse = FVector::ZeroVector;
+
+	/** Radians. */
+	FVector AngularImpulse = FVector::ZeroVector;
+
+	bool bWake = false;
+};
+
+/** Commands of one game frame, consumed by the first physics step that follows it. */
+struct FPropSimInput : public Chaos::FSimCallbackInput
+{
+	TArray<FPropCCDBody> CCDBodies;
+	TArray<FPropKinematicTarget> KinematicTargets;
+	TArray<FPropImpulseCommand> Impulses;
+
+	void Reset()
+	{
+		CCDBodies.Reset();
+		KinematicTargets.Reset();
+		Impulses.Reset();
+	}
+};
+
+/** Results of one physics step, read by the game thread. */
+struct FPropSimOutput : public Chaos::FSimCallbackOutput
+{
+	int32 NumCCDToggles = 0;
+
+	void Reset()
+	{
+		NumCCDToggles = 0;
+	}
+};
+
+/**
+ * Runs the per-step logic of the prop system on the physics thread, at the physics rate
+ * (bPhysicsThreadCallback in the project settings, best with async physics enabled):
+ * CCD switching of every moving prop, kinematic targets of held props and damage impulses.
+ * The game thread only queues commands with the *_External functions and reads the outputs.
+ */
+class GENERICPHYSICPROPSYSTEM_API FPropPhysicsCallback : public Chaos::TSimCallbackObject<FPropSimInput, FPropSimOutput, Chaos::ESimCallbackOptions::Presimulate>
+{
+public:
+	/** Sets the CCD speed threshold of a body, 0 to stop switching its CCD. */
+	void SetCCDThreshold_External(int32 ParticleId, float ThresholdSq);
+
+	/** Moves a kinematic body to a transform during the next physics steps. */
+	void SetKinematicTarget_External(FSingleParticlePhysicsProxy* Proxy, const FTransform& Transform);
+
+	/** Applies impulses to a body at the next physics step. */
+	void AddImpulses_External(const FPropImpulseCommand& Command);
+
+private:
+	virtual void OnPreSimulate_Internal() override;
+
+	/** Physics thread: squared CCD threshold per particle unique index. */
+	TMap<int32, float> CCDThresholds;
+};
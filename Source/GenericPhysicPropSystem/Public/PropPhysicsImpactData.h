@@ -4,33 +4,142 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "UObject/ObjectKey.h"
+#include "Chaos/ChaosEngineInterface.h"
 #include "PropPhysicsImpactData.generated.h"
 
+class UNiagaraSystem;
+class UMaterialInterface;
+class UPhysicalMaterial;
+
+/** Feedback of an impact: sound, particles and decal, all optional. */
 USTRUCT(BlueprintType)
 struct FImpactSoundEntry
 {
 	GENERATED_BODY()
 
+	/** Streamed in with the sound bank of the prop's surface, the hit is silent until then. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
-	USoundBase* ImpactSound = nullptr;
+	TSoftObjectPtr<USoundBase> ImpactSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
 	float VolumeMultiplier = 1.0f;
+
+	/** 
+	 * One-shot (non-looping) system spawned at the contact point, from the pooled components of the prop subsystem.
+	 * Gets the impact strength (0.2 - 1) in the "ImpactStrength" float user parameter.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VFX")
+	UNiagaraSystem* ImpactVFX = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VFX", meta = (ClampMin = "0.01"))
+	float VFXScale = 1.0f;
+
+	/** Decal projected on the hit surface, from the pooled decals of the prop subsystem. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Decal")
+	UMaterialInterface* ImpactDecal = nullptr;
+
+	/** Half extents of the decal box, X being the projection depth. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Decal")
+	FVector DecalSize = FVector(8.0f, 16.0f, 16.0f);
+
+	/** Time (s) before the decal fades out and goes back to the pool. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Decal", meta = (ClampMin = "0.1"))
+	float DecalLifetime = 10.0f;
+};
+
+/** Sound played when a prop made of one surface type hits another surface type. */
+USTRUCT(BlueprintType)
+struct FImpactSurfacePairEntry
+{
+	GENERATED_BODY()
+
+	/** Surface type of the prop's own physical material. Default = any prop without a more specific entry. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Impacts")
+	TEnumAsByte<EPhysicalSurface> PropSurface = SurfaceType_Default;
+
+	/** Surface type of what the prop hit. Default = any surface without a more specific entry. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Impacts")
+	TEnumAsByte<EPhysicalSurface> HitSurface = SurfaceType_Default;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Impacts")
+	FImpactSoundEntry Sound;
 };
 
 /**
- * Data Asset to configure physics impact sounds.
+ * Data Asset to configure physics impact sounds, particles and decals.
+ * Entries are compiled at load into a dense table indexed by (prop surface, hit surface),
+ * so a lookup during a hit is a single array access.
+ * Sounds are soft references, grouped in one bank per prop surface that the prop subsystem streams
+ * in while props of that surface are near an observer.
+ * Resolution order: exact surface pair, hit surface entry, prop surface pair with Default hit, DefaultSound.
  */
 UCLASS(BlueprintType)
-class UPropPhysicsImpactData : public UDataAsset
+class GENERICPHYSICPROPSYSTEM_API UPropPhysicsImpactData : public UDataAsset
 {
 	GENERATED_BODY()
 public:
-	/** Map associating a Physical Material with a sound entry. */
+	/**
+	 * Map associating a Physical Material with a sound entry, whatever the prop is made of.
+	 * Compiled by the material's Surface Type: other materials of that Surface Type share the entry.
+	 * Materials without Surface Type, or sharing theirs with another key, are only matched by pointer.
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Impacts")
 	TMap<UPhysicalMaterial*, FImpactSoundEntry> ImpactMap;
-	
+
+	/** Sounds for specific material pairs (e.g. Metal prop on Concrete vs Wood prop on Concrete). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Impacts")
+	TArray<FImpactSurfacePairEntry> SurfacePairSounds;
+
 	/** Fallback sound if no Physical Material matches. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Impacts")
 	FImpactSoundEntry DefaultSound;
+
+	/** Builds the lookup table from the entries above. Called on load and after edits. */
+	void CompileImpactTable();
+
+	/** Compiles the lookup table if it was never built (e.g. asset created at runtime). */
+	void ConditionalCompileImpactTable()
+	{
+		if (LookupTable.Num() == 0)
+		{
+			CompileImpactTable();
+		}
+	}
+
+	/** 
+	 * Returns the sound to play for a prop surface hitting a physical material. The table must be compiled.
+	 * @param HitMaterial Physical material of what the prop hit, null = DefaultSound unless a Default pair is set.
+	 */
+	const FImpactSoundEntry& FindImpactSound(EPhysicalSurface PropSurface, const UPhysicalMaterial* HitMaterial) const;
+
+	/** Every sound a prop of this surface can play, whatever it hits. The table must be compiled. */
+	const TArray<FSoftObjectPath>& GetSoundBank(EPhysicalSurface PropSurface) const
+	{
+		return SoundBanks[PropSurface];
+	}
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	/**
+	 * Unique entries referenced by the lookup table, index 0 is DefaultSound.
+	 * Effects are kept alive by the UPROPERTY entries they were copied from.
+	 */
+	TArray<FImpactSoundEntry> ResolvedEntries;
+
+	/** Per prop surface, the unique sounds of its row of the lookup table. */
+	TArray<TArray<FSoftObjectPath>> SoundBanks;
+
+	/** SurfaceType_Max x SurfaceType_Max indices into ResolvedEntries, row = prop surface, column = hit surface. */
+	TArray<uint16> LookupTable;
+
+	/** ImpactMap keys only matched by pointer, offset of their SurfaceType_Max column in MaterialLookup. */
+	TMap<TObjectKey<UPhysicalMaterial>, int32> MaterialColumns;
+
+	/** Indices into ResolvedEntries per prop surface, for the materials of MaterialColumns. */
+	TArray<uint16> MaterialLookup;
 };
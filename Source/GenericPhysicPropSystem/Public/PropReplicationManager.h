@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "PropNetState.h"
+#include "PropReplicationManager.generated.h"
+
+class APropReplicationManager;
+struct FPropReplicatedArray;
+
+/** Replicated state of one moving (or just settled) prop. */
+USTRUCT()
+struct FPropReplicatedItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** Stable ID of the prop, identical on the server and on every client. */
+	UPROPERTY()
+	uint32 PropId = 0;
+
+	UPROPERTY()
+	FPropNetState State;
+
+	/** Server only: time at which a prop at rest leaves the array, 0 while it moves. */
+	UPROPERTY(NotReplicated)
+	float RemoveTime = 0.0f;
+
+	void PostReplicatedAdd(const FPropReplicatedArray& InArraySerializer);
+	void PostReplicatedChange(const FPropReplicatedArray& InArraySerializer);
+};
+
+/** States of the props currently moving, delta replicated item by item. */
+USTRUCT()
+struct FPropReplicatedArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FPropReplicatedItem> Items;
+
+	/** Manager owning the array, forwards received states to the prop subsystem. */
+	UPROPERTY(NotReplicated)
+	APropReplicationManager* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FPropReplicatedItem, FPropReplicatedArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FPropReplicatedArray> : public TStructOpsTypeTraitsBase2<FPropReplicatedArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Single replicated actor carrying the state of every awake prop, used when AggregatedReplication
+ * is enabled in the project settings. Props themselves don't replicate: they are matched on clients
+ * by a stable ID, so only level-placed props (same path on server and clients) can be aggregated.
+ * Spawned by UPhysicsPropSubsystem on the server.
+ */
+UCLASS(NotPlaceable, Transient)
+class GENERICPHYSICPROPSYSTEM_API APropReplicationManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	APropReplicationManager();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostInitializeComponents() override;
+
+	/** Server: writes the state of a moving or just settled prop. */
+	void UpdatePropState(uint32 PropId, const FPropNetState& State, float CurrentTime);
+
+	/** Server: removes the props that stayed at rest long enough for clients to get their final state. */
+	void RemoveSettledProps(float CurrentTime);
+
+	/** Server: removes a prop right away (e.g. unregistered). */
+	void RemoveProp(uint32 PropId);
+
+	/** Client: hands a received state to the prop subsystem. */
+	void ReceivePropState(const FPropReplicatedItem& Item) const;
+
+	/** Number of props currently replicated. */
+	int32 GetNumReplicatedProps() const { return States.Items.Num(); }
+
+private:
+	UPROPERTY(Replicated)
+	FPropReplicatedArray States;
+
+	/** Server only: index of each prop's item in States. */
+	TMap<uint32, int32> ItemIndices;
+};
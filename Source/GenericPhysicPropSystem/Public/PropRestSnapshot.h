@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PropRestSnapshot.generated.h"
+
+/**
+ * Baked rest pose of the props of a level, so they start settled and asleep instead of
+ * jittering and waking each other during the first seconds of play.
+ * Place one in the level and click Bake Rest State: the level is duplicated in a hidden world, its props are
+ * simulated until they all sleep, and their transforms are stored in this actor as a compact binary snapshot.
+ * At begin play the props of the level are moved to their baked pose and put to sleep.
+ * Bake again after moving props, props missing from the snapshot simply simulate as usual.
+ */
+UCLASS(HideCategories = (Rendering, Physics, Collision, Input, HLOD, Replication, Networking))
+class GENERICPHYSICPROPSYSTEM_API APropRestSnapshot : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	APropRestSnapshot();
+
+	/** Maximum simulated time (s) of a bake. Props still awake by then are baked as they are, but asleep. */
+	UPROPERTY(EditAnywhere, Category = "Jam Physics|Snapshot", meta = (ClampMin = "1.0"))
+	float MaxBakeTime = 30.0f;
+
+	/** Number of props in the baked snapshot. */
+	UPROPERTY(VisibleAnywhere, Category = "Jam Physics|Snapshot")
+	int32 NumBakedProps = 0;
+
+	/** Simulated time (s) the props of the last bake took to settle. */
+	UPROPERTY(VisibleAnywhere, Category = "Jam Physics|Snapshot")
+	float BakedSettleTime = 0.0f;
+
+#if WITH_EDITOR
+	/** Simulates the props of this level until they sleep and stores their transforms. */
+	UFUNCTION(CallInEditor, Category = "Jam Physics|Snapshot")
+	void BakeRestState();
+
+	/** Removes the baked snapshot, props simulate from their placed pose again. */
+	UFUNCTION(CallInEditor, Category = "Jam Physics|Snapshot")
+	void ClearRestState();
+#endif
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	/** FPropStateSnapshot of the level's props, at rest. */
+	UPROPERTY()
+	TArray<uint8> SnapshotData;
+};
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform spatial hash grid of prop slots.
+ * Only non-empty cells are stored, so the grid has no bounds and costs nothing for empty space.
+ * Queries are clamped to the cells ever occupied, and walk the stored cells instead when that is cheaper.
+ * Ids are the prop slots used by UPhysicsPropSubsystem; the caller keeps the cell of each id.
+ */
+struct GENERICPHYSICPROPSYSTEM_API FPropSpatialHashGrid
+{
+public:
+	explicit FPropSpatialHashGrid(float InCellSize = 2500.0f);
+
+	/** Changes the cell size. Only valid while the grid is empty. */
+	void SetCellSize(float InCellSize);
+
+	float GetCellSize() const { return CellSize; }
+
+	/** Returns the cell containing a world location. */
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** Adds an id to the grid and returns its cell. */
+	FIntVector Add(int32 Id, const FVector& Location);
+
+	/** Removes an id from the cell it was added to. */
+	void Remove(int32 Id, const FIntVector& Cell);
+
+	/** Moves an id to the cell of its new location. Returns the new cell. */
+	FIntVector Move(int32 Id, const FIntVector& OldCell, const FVector& NewLocation);
+
+	/** Replaces an id by another one in a cell, used when the owner swaps slots. */
+	void Rename(int32 OldId, int32 NewId, const FIntVector& Cell);
+
+	void Reset();
+
+	/** Calls Func(const TArray<int32>& CellIds) for every non-empty cell overlapping the sphere bounds. */
+	template<typename FuncType>
+	void ForEachCellInRadius(const FVector& Center, float Radius, FuncType&& Func) const
+	{
+		if (Cells.Num() == 0) return;
+
+		// Flat levels don't pay for the height of the query box
+		const FIntVector Min = GetCell(Center - FVector(Radius)).ComponentMax(OccupiedMin);
+		const FIntVector Max = GetCell(Center + FVector(Radius)).ComponentMin(OccupiedMax);
+		if (Min.X > Max.X || Min.Y > Max.Y || Min.Z > Max.Z) return;
+
+		// Large query over a sparse grid: test the stored cells rather than hash every cell of the box
+		const int64 NumQueryCells = int64(Max.X - Min.X + 1) * int64(Max.Y - Min.Y + 1) * int64(Max.Z - Min.Z + 1);
+		if (NumQueryCells > Cells.Num())
+		{
+			for (const TPair<FIntVector, TArray<int32>>& Pair : Cells)
+			{
+				const FIntVector& Cell = Pair.Key;
+				if (Cell.X >= Min.X && Cell.X <= Max.X && Cell.Y >= Min.Y && Cell.Y <= Max.Y && Cell.Z >= Min.Z && Cell.Z <= Max.Z)
+				{
+					Func(Pair.Value);
+				}
+			}
+			return;
+		}
+
+		for (int32 X = Min.X; X <= Max.X; ++X)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+			{
+				for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+				{
+					if (const TArray<int32>* CellIds = Cells.Find(FIntVector(X, Y, Z)))
+					{
+						Func(*CellIds);
+					}
+				}
+			}
+		}
+	}
+
+	/** Calls Func(int32 Id) for every id stored in a cell overlapping the sphere bounds. */
+	template<typename FuncType>
+	void ForEachInRadius(const FVector& Center, float Radius, FuncType&& Func) const
+	{
+		ForEachCellInRadius(Center, Radius, [&Func](const TArray<int32>& CellIds)
+		{
+			for (const int32 Id : CellIds)
+			{
+				Func(Id);
+			}
+		});
+	}
+
+private:
+	float CellSize;
+	float InvCellSize;
+
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	// Bounds of the cells ever occupied since the last reset, they only grow
+	FIntVector OccupiedMin = FIntVector(MAX_int32);
+	FIntVector OccupiedMax = FIntVector(MIN_int32);
+
+	/** Adds an id to a cell and grows the occupied bounds. */
+	void AddToCell(int32 Id, const FIntVector& Cell);
+};
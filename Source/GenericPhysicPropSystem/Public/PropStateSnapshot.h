@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Physics state of one prop in a snapshot. */
+struct FPropStateRecord
+{
+	/** Stable ID of the prop, from its actor's path name (see UPhysicsPropComponent::MakeStableId). */
+	uint32 PropId = 0;
+
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	/** Only meaningful when awake. */
+	FVector LinearVelocity = FVector::ZeroVector;
+
+	/** Degrees per second, only meaningful when awake. */
+	FVector AngularVelocity = FVector::ZeroVector;
+
+	bool bAwake = false;
+};
+
+/**
+ * Compact binary snapshot of the physics state of many props.
+ * Layout: a header (magic, version, record count), then per prop its ID, location and rotation as floats
+ * and a flag byte, plus velocities for awake props only (33 bytes per prop at rest).
+ * The header and the records can be streamed one by one through any FArchive, no per-actor serialization involved.
+ */
+struct GENERICPHYSICPROPSYSTEM_API FPropStateSnapshot
+{
+	TArray<FPropStateRecord> Records;
+
+	/** Reads or writes the whole snapshot. Returns false when loading data that isn't a snapshot of this version. */
+	bool Serialize(FArchive& Ar);
+
+	/** 
+	 * Reads or writes the header. Returns false when loading data that isn't a snapshot of this version,
+	 * or whose record count doesn't fit in the rest of the archive.
+	 */
+	static bool SerializeHeader(FArchive& Ar, int32& NumRecords);
+
+	/** Reads or writes one record. */
+	static void SerializeRecord(FArchive& Ar, FPropStateRecord& Record);
+};